@@ -0,0 +1,429 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "binary_dataset.h"
+#include "csv_loader.h"
+#include "kernels.h"
+#include "single_layer_perceptron.h"
+
+/**
+  * Dá acesso aos métodos internos de SingleLayerPerceptron que são medidos pelo benchmark.
+  */
+struct PerceptronBenchmark {
+    static int act_func(const SingleLayerPerceptron &model, std::span<const int> data, int i) {
+        return model.act_func(data, model.row(i));
+    }
+
+    static void ch_weights(SingleLayerPerceptron &model, std::span<const int> data, int target, int output, int i) {
+        model.ch_weights(data, target, output, model.row(i));
+    }
+
+    static EpochStats internal_train(SingleLayerPerceptron &model, const MatrixView<int> &dataset,
+                                     const MatrixView<int> &target) {
+        return model.internal_train(dataset, target);
+    }
+};
+
+namespace {
+
+/**
+  * Parâmetros da execução, lidos da linha de comando.
+  */
+struct Options {
+    std::vector<std::size_t> dimensions = {63, 1024, 16384, 262144, 1048576};
+    std::vector<std::size_t> classes = {1, 8, 64};
+    std::vector<std::size_t> samples = {64, 1024, 16384};
+    std::uint64_t seed = 42;
+    std::size_t memory_mb = 1024;
+    // Tempo mínimo e número mínimo de medições de cada caso
+    double min_seconds = 0.5;
+    std::size_t min_reps = 10;
+    std::string format = "csv";
+    std::string output;
+};
+
+/**
+  * Resultado de um caso do benchmark. As latências são por operação, em nanossegundos.
+  */
+struct Result {
+    std::string benchmark;
+    std::size_t dimension = 0;
+    std::size_t classes = 0;
+    std::size_t samples = 0;
+    std::size_t reps = 0;
+    std::size_t batch = 0;
+    double p50_ns = 0;
+    double p90_ns = 0;
+    double p99_ns = 0;
+    double mean_ns = 0;
+    double ops_per_s = 0;
+    double gb_per_s = 0;
+};
+
+// Acumula os resultados das operações medidas para que o compilador não as elimine
+volatile std::int64_t sink = 0;
+
+using Clock = std::chrono::steady_clock;
+
+// Duração mínima de uma medição; operações mais rápidas são repetidas 'batch' vezes em cada medição
+constexpr double min_batch_ns = 20000.0;
+constexpr std::size_t max_reps = 100000;
+
+double elapsed_ns(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+/**
+  * Mede uma operação: escolhe quantas chamadas cabem em cada medição, repete as medições até atingir o tempo
+  * e o número mínimos e calcula os percentis da latência por chamada.
+  *
+  * @param options Os parâmetros da execução.
+  * @param result Recebe as medições; a identificação do caso já deve estar preenchida.
+  * @param bytes_per_op O número de bytes lidos ou escritos por chamada, para calcular a vazão em GB/s.
+  * @param op A operação; recebe o número da chamada.
+  */
+void measure(const Options &options, Result &result, double bytes_per_op, const std::function<void(std::size_t)> &op) {
+    std::size_t calls = 0;
+    std::size_t batch = 1;
+    for (;;) {
+        const auto start = Clock::now();
+        for (std::size_t k = 0; k < batch; ++k) {
+            op(calls++);
+        }
+        if (elapsed_ns(start) >= min_batch_ns || batch >= (std::size_t{1} << 24)) {
+            break;
+        }
+        batch *= 2;
+    }
+
+    std::vector<double> latencies;
+    double total_ns = 0;
+    while (latencies.size() < max_reps && (latencies.size() < options.min_reps || total_ns < options.min_seconds * 1e9)) {
+        const auto start = Clock::now();
+        for (std::size_t k = 0; k < batch; ++k) {
+            op(calls++);
+        }
+        const double ns = elapsed_ns(start);
+        total_ns += ns;
+        latencies.push_back(ns / static_cast<double>(batch));
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile = [&](double p) {
+        const auto rank = static_cast<std::size_t>(p * static_cast<double>(latencies.size() - 1) + 0.5);
+        return latencies[rank];
+    };
+    result.reps = latencies.size();
+    result.batch = batch;
+    result.p50_ns = percentile(0.50);
+    result.p90_ns = percentile(0.90);
+    result.p99_ns = percentile(0.99);
+    result.mean_ns = total_ns / static_cast<double>(latencies.size() * batch);
+    result.ops_per_s = 1e9 / result.mean_ns;
+    result.gb_per_s = bytes_per_op / result.mean_ns;
+}
+
+/**
+  * Gera um conjunto de dados bipolar aleatório, como o conjunto de caracteres, com saídas -1 ou +1.
+  */
+void generate(std::mt19937_64 &rng, std::size_t count, std::vector<int> &values) {
+    values.resize(count);
+    for (std::size_t k = 0; k < count; k += 64) {
+        std::uint64_t bits = rng();
+        for (std::size_t j = k; j < std::min(count, k + 64); ++j, bits >>= 1) {
+            values[j] = (bits & 1u) ? 1 : -1;
+        }
+    }
+}
+
+/**
+  * Grava um conjunto de dados em um CSV no formato de 'readData'.
+  */
+void write_csv(const std::string &filename, const std::vector<int> &features, std::size_t dimension,
+               const std::vector<int> &labels, std::size_t label_width) {
+    std::ofstream out(filename, std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("bench: nao foi possivel criar " + filename);
+    }
+    const std::size_t rows = features.size() / dimension;
+    std::string line;
+    for (std::size_t n = 0; n < rows; ++n) {
+        line.clear();
+        for (std::size_t j = 0; j < dimension; ++j) {
+            line += features[n * dimension + j] > 0 ? "1," : "-1,";
+        }
+        for (std::size_t i = 0; i < label_width; ++i) {
+            line += labels[n * label_width + i] > 0 ? "1" : "-1";
+            line += i + 1 < label_width ? ',' : '\n';
+        }
+        out << line;
+    }
+    if (!out) {
+        throw std::runtime_error("bench: erro ao gravar " + filename);
+    }
+}
+
+std::vector<std::size_t> parse_list(const std::string &text) {
+    std::vector<std::size_t> values;
+    for (std::size_t first = 0; first <= text.size();) {
+        const std::size_t comma = std::min(text.find(',', first), text.size());
+        values.push_back(std::stoull(text.substr(first, comma - first)));
+        first = comma + 1;
+    }
+    return values;
+}
+
+void print_usage(const char *program) {
+    std::cerr << "Uso: " << program << " [--quick] [--dims a,b,...] [--classes a,b,...] [--samples a,b,...]\n"
+              << "       [--seed n] [--memory-mb n] [--min-time segundos] [--format csv|json] [--output arquivo]"
+              << std::endl;
+}
+
+bool parse_options(int argc, char *argv[], Options &options) {
+    for (int k = 1; k < argc; ++k) {
+        const std::string arg = argv[k];
+        if (arg == "--quick") {
+            options.dimensions = {63, 4096, 1048576};
+            options.classes = {26};
+            options.samples = {16};
+            options.min_seconds = 0.05;
+            options.min_reps = 3;
+            continue;
+        }
+        if (k + 1 >= argc) {
+            return false;
+        }
+        const std::string value = argv[++k];
+        if (arg == "--dims") {
+            options.dimensions = parse_list(value);
+        } else if (arg == "--classes") {
+            options.classes = parse_list(value);
+        } else if (arg == "--samples") {
+            options.samples = parse_list(value);
+        } else if (arg == "--seed") {
+            options.seed = std::stoull(value);
+        } else if (arg == "--memory-mb") {
+            options.memory_mb = std::stoull(value);
+        } else if (arg == "--min-time") {
+            options.min_seconds = std::stod(value);
+        } else if (arg == "--format" && (value == "csv" || value == "json")) {
+            options.format = value;
+        } else if (arg == "--output") {
+            options.output = value;
+        } else {
+            return false;
+        }
+    }
+    const auto valid = [](const std::vector<std::size_t> &list) {
+        return !list.empty() && std::find(list.begin(), list.end(), 0) == list.end();
+    };
+    return valid(options.dimensions) && valid(options.classes) && valid(options.samples);
+}
+
+void write_results(std::ostream &out, const Options &options, const std::vector<Result> &results) {
+    const std::string isa = kernels::active().name;
+    if (options.format == "csv") {
+        out << "benchmark,isa,seed,dimension,classes,samples,reps,batch,p50_ns,p90_ns,p99_ns,mean_ns,ops_per_s,gb_per_s\n";
+        for (const auto &r: results) {
+            out << r.benchmark << ',' << isa << ',' << options.seed << ',' << r.dimension << ',' << r.classes << ','
+                << r.samples << ',' << r.reps << ',' << r.batch << ',' << r.p50_ns << ',' << r.p90_ns << ','
+                << r.p99_ns << ',' << r.mean_ns << ',' << r.ops_per_s << ',' << r.gb_per_s << '\n';
+        }
+        return;
+    }
+    out << "{\n  \"isa\": \"" << isa << "\",\n  \"seed\": " << options.seed << ",\n  \"results\": [";
+    for (std::size_t k = 0; k < results.size(); ++k) {
+        const Result &r = results[k];
+        out << (k == 0 ? "\n" : ",\n") << "    {\"benchmark\": \"" << r.benchmark << "\", \"dimension\": "
+            << r.dimension << ", \"classes\": " << r.classes << ", \"samples\": " << r.samples << ", \"reps\": "
+            << r.reps << ", \"batch\": " << r.batch << ", \"p50_ns\": " << r.p50_ns << ", \"p90_ns\": " << r.p90_ns
+            << ", \"p99_ns\": " << r.p99_ns << ", \"mean_ns\": " << r.mean_ns << ", \"ops_per_s\": " << r.ops_per_s
+            << ", \"gb_per_s\": " << r.gb_per_s << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+/**
+  * Executa todos os casos de uma dimensão e um tamanho de conjunto de dados.
+  * As operações sobre um único ponto de dados (act_func, ch_weights e predict) só são medidas com o primeiro
+  * tamanho de conjunto, já que não dependem dele.
+  */
+void run_case(const Options &options, std::size_t dim, std::size_t samples, bool single_sample_ops,
+              std::vector<Result> &results) {
+    const double budget = static_cast<double>(options.memory_mb) * 1024.0 * 1024.0;
+    const double feature_bytes = static_cast<double>(samples * dim * sizeof(int));
+    if (2 * feature_bytes > budget) {
+        std::cerr << "ignorado: dimensao " << dim << ", " << samples << " amostras (excede --memory-mb)" << std::endl;
+        return;
+    }
+
+    // Cada caso tem a sua própria semente, então o resultado de um caso não depende dos casos executados antes
+    std::mt19937_64 rng(options.seed ^ (dim * 0x9E3779B97F4A7C15ULL) ^ samples);
+    std::vector<int> features;
+    generate(rng, samples * dim, features);
+    const MatrixView<int> dataset{features, dim};
+    const std::size_t max_classes = *std::max_element(options.classes.begin(), options.classes.end());
+
+    for (std::size_t classes: options.classes) {
+        const double weight_bytes = static_cast<double>(classes * (dim + 8) * sizeof(double));
+        if (feature_bytes + weight_bytes > budget) {
+            std::cerr << "ignorado: dimensao " << dim << ", " << classes << " classes (excede --memory-mb)"
+                      << std::endl;
+            continue;
+        }
+        std::cerr << "dimensao " << dim << ", " << classes << " classes, " << samples << " amostras" << std::endl;
+
+        std::vector<int> labels;
+        generate(rng, samples * classes, labels);
+        const MatrixView<int> target{labels, classes};
+        SingleLayerPerceptron model(static_cast<int>(dim), static_cast<int>(classes), 1.0, 0.2);
+        const auto base = [&](const char *name) {
+            Result result;
+            result.benchmark = name;
+            result.dimension = dim;
+            result.classes = classes;
+            result.samples = samples;
+            return result;
+        };
+        const double row_bytes = static_cast<double>(dim * (sizeof(int) + sizeof(double)));
+
+        if (single_sample_ops) {
+            // act_func e ch_weights tratam um único neurônio, então só dependem da dimensão
+            if (classes == options.classes.front()) {
+                Result act = base("act_func");
+                measure(options, act, row_bytes, [&](std::size_t k) {
+                    sink = sink + PerceptronBenchmark::act_func(model, dataset[k % samples], 0);
+                });
+                results.push_back(act);
+
+                // A saída nunca corresponde ao alvo, então todas as chamadas atualizam os pesos
+                Result change = base("ch_weights");
+                measure(options, change, row_bytes + static_cast<double>(dim * sizeof(double)), [&](std::size_t k) {
+                    const int expected = (k & 1u) ? 1 : -1;
+                    PerceptronBenchmark::ch_weights(model, dataset[k % samples], expected, -expected, 0);
+                });
+                results.push_back(change);
+            }
+
+            std::vector<std::vector<int>> pool;
+            for (std::size_t n = 0; n < std::min<std::size_t>(samples, 16); ++n) {
+                pool.emplace_back(dataset[n].begin(), dataset[n].end());
+            }
+            Result single = base("predict");
+            measure(options, single, row_bytes * static_cast<double>(classes), [&](std::size_t k) {
+                sink = sink + model.predict(pool[k % pool.size()])[0];
+            });
+            results.push_back(single);
+
+            // A mesma predição escrevendo em buffers reaproveitados, sem alocações
+            std::vector<int> into(classes);
+            std::vector<double> net(classes);
+            Result span = base("predict_span");
+            measure(options, span, row_bytes * static_cast<double>(classes), [&](std::size_t k) {
+                model.predict(pool[k % pool.size()], into, net);
+                sink = sink + into[0];
+            });
+            results.push_back(span);
+        }
+
+        std::vector<int> output(samples * classes);
+        Result batch = base("predict_batch");
+        measure(options, batch, feature_bytes + weight_bytes, [&](std::size_t) {
+            model.predict_batch(features, output);
+            sink = sink + output[0];
+        });
+        results.push_back(batch);
+
+        // Os alvos são aleatórios, então o treinamento não converge e todas as épocas custam o mesmo
+        Result epoch = base("internal_train");
+        measure(options, epoch, row_bytes * static_cast<double>(samples * classes), [&](std::size_t) {
+            sink = sink + static_cast<std::int64_t>(PerceptronBenchmark::internal_train(model, dataset, target).updates);
+        });
+        results.push_back(epoch);
+    }
+
+    // Leitura de um CSV com o maior número de classes: cerca de 2.5 caracteres por valor
+    const double csv_bytes = 2.5 * static_cast<double>(samples * (dim + max_classes));
+    if (csv_bytes + 3 * feature_bytes > budget) {
+        std::cerr << "ignorado: leitura de CSV com dimensao " << dim << ", " << samples << " amostras" << std::endl;
+        return;
+    }
+    std::vector<int> labels;
+    generate(rng, samples * max_classes, labels);
+    const std::string filename = (std::filesystem::temp_directory_path() /
+                                  ("slp_bench_" + std::to_string(dim) + "_" + std::to_string(samples) + ".csv")).string();
+    write_csv(filename, features, dim, labels, max_classes);
+    const auto file_bytes = static_cast<double>(std::filesystem::file_size(filename));
+    const int columns = static_cast<int>(dim);
+
+    Result load{"loadCsv", dim, max_classes, samples};
+    measure(options, load, file_bytes, [&](std::size_t) {
+        sink = sink + static_cast<std::int64_t>(loadCsv(filename, columns).rows);
+    });
+    results.push_back(load);
+
+    Result read{"readData", dim, max_classes, samples};
+    measure(options, read, file_bytes, [&](std::size_t) {
+        sink = sink + static_cast<std::int64_t>(readData(filename, columns).size());
+    });
+    results.push_back(read);
+    std::filesystem::remove(filename);
+}
+
+} // namespace
+
+/**
+  * Mede a latência e a vazão de act_func, ch_weights, internal_train, predict, predict_span, predict_batch, loadCsv
+  * e readData, variando a dimensão, o número de classes e o tamanho do conjunto de dados, e grava os resultados em
+  * CSV ou JSON.
+  *
+  * Os dados são bipolares e aleatórios, gerados a partir de uma semente fixa (--seed), então duas execuções
+  * medem exatamente o mesmo trabalho. Casos cuja memória estimada excede --memory-mb são ignorados.
+  */
+int main(int argc, char *argv[]) {
+    Options options;
+    bool valid_options = false;
+    try {
+        valid_options = parse_options(argc, argv, options);
+    } catch (const std::exception &) {
+        valid_options = false;
+    }
+    if (!valid_options) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    std::vector<Result> results;
+    try {
+        for (std::size_t dim: options.dimensions) {
+            for (std::size_t s = 0; s < options.samples.size(); ++s) {
+                run_case(options, dim, options.samples[s], s == 0, results);
+            }
+        }
+
+        if (options.output.empty()) {
+            write_results(std::cout, options, results);
+        } else {
+            std::ofstream out(options.output, std::ios::trunc);
+            write_results(out, options, results);
+            if (!out) {
+                throw std::runtime_error("bench: erro ao gravar " + options.output);
+            }
+        }
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
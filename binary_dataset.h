@@ -0,0 +1,230 @@
+#ifndef SINGLELAYERPERCEPTRON_BINARY_DATASET_H
+#define SINGLELAYERPERCEPTRON_BINARY_DATASET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+#include "bipolar.h"
+#include "csv_loader.h"
+#include "dataset.h"
+#include "mapped_file.h"
+
+/**
+  * Visão somente leitura de um conjunto de dados bipolar empacotado guardado em um único buffer.
+  */
+struct BipolarMatrixView {
+    std::span<const std::uint64_t> words;
+    std::size_t words_per_sample = 0;
+
+    [[nodiscard]] std::size_t size() const { return words_per_sample == 0 ? 0 : words.size() / words_per_sample; }
+
+    BipolarSample operator[](std::size_t n) const { return {words.subspan(n * words_per_sample, words_per_sample)}; }
+};
+
+/**
+  * Cabeçalho do formato binário de conjuntos de dados (versão 1).
+  *
+  * O arquivo começa com este cabeçalho de 64 bytes, seguido do bloco de pontos de dados e do bloco de saídas
+  * desejadas, ambos começando em deslocamentos múltiplos de 64 bytes. Os valores são gravados na ordem de bytes
+  * da máquina; 'byte_order' permite detectar um arquivo gravado em uma máquina com ordem diferente.
+  *
+  * - element_type int32: o ponto de dados n ocupa 'dimension' valores int32 consecutivos.
+  * - element_type bipolar: o ponto de dados n ocupa ceil(dimension / 64) palavras de 64 bits, no formato de
+  *   PackedBipolarDataset.
+  * - As saídas desejadas são sempre 'label_width' valores int32 por amostra.
+  */
+struct BinaryDatasetHeader {
+    static constexpr char expected_magic[8] = {'S', 'L', 'P', 'D', 'A', 'T', 'A', '\0'};
+    static constexpr std::uint32_t current_version = 1;
+    static constexpr std::uint32_t native_byte_order = 0x01020304;
+
+    enum ElementType : std::uint32_t {
+        int32 = 1,
+        bipolar = 2
+    };
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint32_t element_type;
+    std::uint32_t reserved0;
+    std::uint64_t sample_count;
+    std::uint64_t dimension;
+    std::uint64_t label_width;
+    std::uint64_t feature_offset;
+    std::uint64_t label_offset;
+};
+
+static_assert(sizeof(BinaryDatasetHeader) == 64, "o cabecalho do formato binario deve ter 64 bytes");
+
+/**
+  * Conjunto de dados no formato binário, mapeado em memória.
+  * Os pontos de dados e as saídas desejadas são usados diretamente a partir das páginas mapeadas, sem
+  * interpretação nem cópia, então abrir o arquivo custa o mesmo independentemente do tamanho do conjunto.
+  */
+class BinaryDataset {
+private:
+    MappedFile file;
+    BinaryDatasetHeader header{};
+
+    /**
+      * Verifica se um bloco de 'count' itens de 'item_bytes' bytes começando em 'offset' cabe no arquivo,
+      * sem estouro nas multiplicações.
+      */
+    [[nodiscard]] bool block_fits(std::uint64_t offset, std::uint64_t count, std::uint64_t item_bytes) const {
+        if (offset % 64 != 0 || offset > file.size()) {
+            return false;
+        }
+        const std::uint64_t available = file.size() - offset;
+        return item_bytes == 0 || count <= available / item_bytes;
+    }
+
+public:
+    /**
+      * Abre e valida um conjunto de dados no formato binário.
+      *
+      * @param filename O caminho do arquivo.
+      * @throws std::runtime_error se o arquivo não puder ser aberto ou não estiver no formato esperado.
+      */
+    explicit BinaryDataset(const std::string &filename) : file(filename) {
+        if (file.size() < sizeof(BinaryDatasetHeader)) {
+            throw std::runtime_error("BinaryDataset: " + filename + " e menor que o cabecalho");
+        }
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, BinaryDatasetHeader::expected_magic, sizeof(header.magic)) != 0) {
+            throw std::runtime_error("BinaryDataset: " + filename + " nao e um conjunto de dados binario");
+        }
+        if (header.byte_order != BinaryDatasetHeader::native_byte_order) {
+            throw std::runtime_error("BinaryDataset: " + filename + " foi gravado com outra ordem de bytes");
+        }
+        if (header.version != BinaryDatasetHeader::current_version) {
+            throw std::runtime_error("BinaryDataset: versao " + std::to_string(header.version) + " de " + filename +
+                                     " nao suportada");
+        }
+        if (header.element_type != BinaryDatasetHeader::int32 && header.element_type != BinaryDatasetHeader::bipolar) {
+            throw std::runtime_error("BinaryDataset: tipo de elemento desconhecido em " + filename);
+        }
+        const std::uint64_t feature_row_bytes = is_bipolar() ? (header.dimension + 63) / 64 * sizeof(std::uint64_t)
+                                                             : header.dimension * sizeof(std::int32_t);
+        if (header.dimension > file.size() * 8 || header.label_width > file.size() ||
+            !block_fits(header.feature_offset, header.sample_count, feature_row_bytes) ||
+            !block_fits(header.label_offset, header.sample_count, header.label_width * sizeof(std::int32_t))) {
+            throw std::runtime_error("BinaryDataset: blocos de dados invalidos em " + filename);
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const { return header.sample_count; }
+
+    [[nodiscard]] std::size_t dimension() const { return header.dimension; }
+
+    [[nodiscard]] std::size_t label_width() const { return header.label_width; }
+
+    [[nodiscard]] bool is_bipolar() const { return header.element_type == BinaryDatasetHeader::bipolar; }
+
+    /**
+      * Pontos de dados de um conjunto com elementos int32.
+      */
+    [[nodiscard]] MatrixView<int> features() const {
+        if (is_bipolar()) {
+            throw std::logic_error("BinaryDataset: o conjunto e bipolar; use bipolar_features");
+        }
+        const auto *values = reinterpret_cast<const int *>(file.data() + header.feature_offset);
+        return {{values, header.sample_count * header.dimension}, header.dimension};
+    }
+
+    /**
+      * Pontos de dados de um conjunto bipolar empacotado.
+      */
+    [[nodiscard]] BipolarMatrixView bipolar_features() const {
+        if (!is_bipolar()) {
+            throw std::logic_error("BinaryDataset: o conjunto nao e bipolar; use features");
+        }
+        const std::size_t words = (header.dimension + 63) / 64;
+        const auto *values = reinterpret_cast<const std::uint64_t *>(file.data() + header.feature_offset);
+        return {{values, header.sample_count * words}, words};
+    }
+
+    /**
+      * Saídas desejadas de todas as amostras.
+      */
+    [[nodiscard]] MatrixView<int> labels() const {
+        const auto *values = reinterpret_cast<const int *>(file.data() + header.label_offset);
+        return {{values, header.sample_count * header.label_width}, header.label_width};
+    }
+};
+
+/**
+  * Preenche o cabeçalho de um conjunto de dados no formato binário, com os blocos logo após o cabeçalho.
+  *
+  * @param bipolar Se os pontos de dados são gravados empacotados.
+  * @param sample_count O número de amostras.
+  * @param dimension A dimensão dos pontos de dados.
+  * @param label_width O número de saídas desejadas de cada amostra.
+  * @return O cabeçalho, com os deslocamentos dos blocos alinhados a 64 bytes.
+  */
+inline BinaryDatasetHeader makeBinaryDatasetHeader(bool bipolar, std::uint64_t sample_count, std::uint64_t dimension,
+                                                   std::uint64_t label_width) {
+    const auto align = [](std::uint64_t offset) { return (offset + 63) / 64 * 64; };
+    const std::uint64_t feature_bytes = bipolar ? sample_count * ((dimension + 63) / 64) * sizeof(std::uint64_t)
+                                                : sample_count * dimension * sizeof(std::int32_t);
+
+    BinaryDatasetHeader header{};
+    std::memcpy(header.magic, BinaryDatasetHeader::expected_magic, sizeof(header.magic));
+    header.version = BinaryDatasetHeader::current_version;
+    header.byte_order = BinaryDatasetHeader::native_byte_order;
+    header.element_type = bipolar ? BinaryDatasetHeader::bipolar : BinaryDatasetHeader::int32;
+    header.sample_count = sample_count;
+    header.dimension = dimension;
+    header.label_width = label_width;
+    header.feature_offset = align(sizeof(header));
+    header.label_offset = align(header.feature_offset + feature_bytes);
+    return header;
+}
+
+/**
+  * Grava um conjunto de dados no formato binário.
+  * Se todos os pontos de dados forem bipolares e 'allow_bipolar' for verdadeiro, eles são gravados empacotados.
+  *
+  * @param csv Os dados, por exemplo lidos por 'loadCsv' ou 'readData'.
+  * @param filename O caminho do arquivo binário.
+  * @param allow_bipolar Permite gravar os pontos de dados empacotados quando forem bipolares.
+  * @throws std::runtime_error se o arquivo não puder ser gravado.
+  */
+inline void writeBinaryDataset(const Dataset &csv, const std::string &filename, bool allow_bipolar = true) {
+    PackedBipolarDataset packed;
+    const bool bipolar = allow_bipolar && PackedBipolarDataset::pack(csv.features, csv.data_columns, packed);
+
+    const std::uint64_t feature_bytes = bipolar ? packed.size() * packed.words() * sizeof(std::uint64_t)
+                                                : csv.features.size() * sizeof(std::int32_t);
+    const BinaryDatasetHeader header = makeBinaryDatasetHeader(bipolar, csv.rows, csv.data_columns, csv.label_columns);
+
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("writeBinaryDataset: nao foi possivel criar " + filename);
+    }
+    const char padding[64] = {};
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(padding, static_cast<std::streamsize>(header.feature_offset - sizeof(header)));
+    if (bipolar) {
+        for (std::size_t n = 0; n < packed.size(); ++n) {
+            const auto words = packed[n].words;
+            out.write(reinterpret_cast<const char *>(words.data()),
+                      static_cast<std::streamsize>(words.size_bytes()));
+        }
+    } else {
+        out.write(reinterpret_cast<const char *>(csv.features.data()), static_cast<std::streamsize>(feature_bytes));
+    }
+    out.write(padding, static_cast<std::streamsize>(header.label_offset - header.feature_offset - feature_bytes));
+    out.write(reinterpret_cast<const char *>(csv.labels.data()),
+              static_cast<std::streamsize>(csv.labels.size() * sizeof(std::int32_t)));
+    if (!out) {
+        throw std::runtime_error("writeBinaryDataset: erro ao gravar " + filename);
+    }
+}
+
+#endif //SINGLELAYERPERCEPTRON_BINARY_DATASET_H
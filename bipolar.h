@@ -0,0 +1,292 @@
+#ifndef SINGLELAYERPERCEPTRON_BIPOLAR_H
+#define SINGLELAYERPERCEPTRON_BIPOLAR_H
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+/**
+  * Ponto de dados bipolar (todos os valores são -1 ou +1) empacotado em palavras de 64 bits.
+  * O bit j é 1 quando o valor j é +1 e 0 quando é -1; os bits além da dimensão são sempre 0.
+  */
+struct BipolarSample {
+    std::span<const std::uint64_t> words;
+};
+
+/**
+  * Conjunto de dados bipolar empacotado: cada amostra ocupa 'words' palavras de 64 bits consecutivas,
+  * ou seja, 1 bit por valor em vez dos 32 bits de um int.
+  */
+class PackedBipolarDataset {
+private:
+    std::size_t dim = 0;
+    std::size_t words_per_sample = 0;
+    std::vector<std::uint64_t> bits;
+
+public:
+    PackedBipolarDataset() = default;
+
+    explicit PackedBipolarDataset(std::size_t dimension)
+            : dim(dimension), words_per_sample((dimension + 63) / 64) {}
+
+    /**
+      * Verifica se todos os valores de um ponto de dados são -1 ou +1.
+      *
+      * @param data Um vetor de inteiros representando um ponto de dados.
+      * @return Verdadeiro se o ponto de dados é bipolar.
+      */
+    static bool is_bipolar(std::span<const int> data) {
+        for (int value: data) {
+            if (value != 1 && value != -1) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+      * Empacota um conjunto de dados, se todos os seus valores forem bipolares.
+      *
+      * @param dataset Um vetor 2D de números inteiros com os pontos de dados, todos da mesma dimensão.
+      * @param packed Recebe o conjunto empacotado quando o conjunto é bipolar.
+      * @return Verdadeiro se o conjunto é bipolar e foi empacotado.
+      */
+    static bool pack(const std::vector<std::vector<int>> &dataset, PackedBipolarDataset &packed) {
+        PackedBipolarDataset result(dataset.empty() ? 0 : dataset.front().size());
+        result.bits.reserve(dataset.size() * result.words_per_sample);
+        for (const auto &data: dataset) {
+            if (data.size() != result.dim || !is_bipolar(data)) {
+                return false;
+            }
+            result.push_back(data);
+        }
+        packed = std::move(result);
+        return true;
+    }
+
+    /**
+      * Empacota um conjunto de dados guardado linha a linha em um único buffer, se todos os seus valores forem bipolares.
+      *
+      * @param features Matriz N x dimension, linha a linha, com os pontos de dados.
+      * @param dimension A dimensão dos pontos de dados.
+      * @param packed Recebe o conjunto empacotado quando o conjunto é bipolar.
+      * @return Verdadeiro se o conjunto é bipolar e foi empacotado.
+      */
+    static bool pack(std::span<const int> features, std::size_t dimension, PackedBipolarDataset &packed) {
+        if (dimension == 0 || features.size() % dimension != 0 || !is_bipolar(features)) {
+            return false;
+        }
+        PackedBipolarDataset result(dimension);
+        result.bits.reserve(features.size() / dimension * result.words_per_sample);
+        for (std::size_t first = 0; first < features.size(); first += dimension) {
+            result.push_back(features.subspan(first, dimension));
+        }
+        packed = std::move(result);
+        return true;
+    }
+
+    /**
+      * Adiciona um ponto de dados bipolar ao final do conjunto.
+      *
+      * @param data Um vetor de inteiros com 'dimension' valores -1 ou +1.
+      */
+    void push_back(std::span<const int> data) {
+        if (data.size() != dim) {
+            throw std::invalid_argument("PackedBipolarDataset: dimensao incorreta");
+        }
+        bits.resize(bits.size() + words_per_sample, 0);
+        std::uint64_t *words = bits.data() + bits.size() - words_per_sample;
+        for (std::size_t j = 0; j < dim; ++j) {
+            if (data[j] == 1) {
+                words[j / 64] |= std::uint64_t{1} << (j % 64);
+            } else if (data[j] != -1) {
+                throw std::invalid_argument("PackedBipolarDataset: valor nao bipolar");
+            }
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const { return words_per_sample == 0 ? 0 : bits.size() / words_per_sample; }
+
+    [[nodiscard]] bool empty() const { return bits.empty(); }
+
+    [[nodiscard]] std::size_t dimension() const { return dim; }
+
+    [[nodiscard]] std::size_t words() const { return words_per_sample; }
+
+    BipolarSample operator[](std::size_t i) const {
+        return {std::span<const std::uint64_t>(bits).subspan(i * words_per_sample, words_per_sample)};
+    }
+};
+
+/**
+  * Pesos inteiros de um modelo decompostos em planos de bits com sinal separado, para calcular o produto escalar
+  * com entradas bipolares empacotadas usando apenas XOR e popcount.
+  *
+  * Para cada neurônio guarda a palavra de sinais g (bit 1 para peso negativo) e os planos p_b com o bit b do valor
+  * absoluto dos pesos. Como x[j] * sinal[j] é +1 exatamente quando o bit de x e o bit de g diferem, com e = x XOR g:
+  *
+  *     x . w = soma_b 2^b * (2 * popcount(p_b AND e) - popcount(p_b))
+  *
+  * Os planos só existem quando todos os pesos e bias são inteiros; caso contrário 'valid' é falso.
+  */
+class BitplaneWeights {
+private:
+    std::size_t words = 0;
+    std::size_t planes = 0;
+    bool is_valid = false;
+
+    // Por neurônio: 'words' palavras de sinal seguidas de 'planes' planos de 'words' palavras
+    std::vector<std::uint64_t> bits;
+    // Por neurônio e plano: popcount(p_b)
+    std::vector<std::int64_t> plane_count;
+    std::vector<std::int64_t> bias;
+
+    [[nodiscard]] const std::uint64_t *neuron(std::size_t i) const {
+        return bits.data() + i * (planes + 1) * words;
+    }
+
+public:
+    /**
+      * Decompõe a matriz de pesos em planos de bits.
+      *
+      * @param weights Ponteiro para a primeira linha da matriz de pesos; o bias de cada linha fica na posição 'dimension'.
+      * @param stride Distância entre duas linhas da matriz de pesos.
+      * @param dimension A dimensão dos dados de entrada.
+      * @param num_classes O número de neurônios.
+      */
+    void build(const double *weights, std::size_t stride, std::size_t dimension, std::size_t num_classes) {
+        is_valid = false;
+        words = (dimension + 63) / 64;
+
+        // Os planos só representam pesos inteiros cujo produto escalar é exato em double (|w| < 2^31)
+        constexpr double limit = 2147483648.0;
+        std::uint64_t max_magnitude = 0;
+        for (std::size_t i = 0; i < num_classes; ++i) {
+            const double *row = weights + i * stride;
+            for (std::size_t j = 0; j <= dimension; ++j) {
+                if (row[j] != std::trunc(row[j]) || std::fabs(row[j]) >= limit) {
+                    return;
+                }
+                max_magnitude = std::max(max_magnitude, static_cast<std::uint64_t>(std::fabs(row[j])));
+            }
+        }
+
+        planes = static_cast<std::size_t>(std::bit_width(max_magnitude));
+        bits.assign(num_classes * (planes + 1) * words, 0);
+        plane_count.assign(num_classes * planes, 0);
+        bias.assign(num_classes, 0);
+
+        for (std::size_t i = 0; i < num_classes; ++i) {
+            const double *row = weights + i * stride;
+            std::uint64_t *block = bits.data() + i * (planes + 1) * words;
+            for (std::size_t j = 0; j < dimension; ++j) {
+                const auto value = static_cast<std::int64_t>(row[j]);
+                const auto magnitude = static_cast<std::uint64_t>(value < 0 ? -value : value);
+                const std::uint64_t bit = std::uint64_t{1} << (j % 64);
+                if (value < 0) {
+                    block[j / 64] |= bit;
+                }
+                for (std::size_t b = 0; b < planes; ++b) {
+                    if ((magnitude >> b) & 1u) {
+                        block[(b + 1) * words + j / 64] |= bit;
+                    }
+                }
+            }
+            for (std::size_t b = 0; b < planes; ++b) {
+                std::int64_t count = 0;
+                for (std::size_t k = 0; k < words; ++k) {
+                    count += std::popcount(block[(b + 1) * words + k]);
+                }
+                plane_count[i * planes + b] = count;
+            }
+            bias[i] = static_cast<std::int64_t>(row[dimension]);
+        }
+        is_valid = true;
+    }
+
+    [[nodiscard]] bool valid() const { return is_valid; }
+
+    /**
+      * Calcula a entrada líquida (produto escalar mais bias) de um neurônio para uma entrada bipolar empacotada.
+      *
+      * @param i O índice do neurônio.
+      * @param sample O ponto de dados empacotado.
+      * @return A entrada líquida, exata.
+      */
+    [[nodiscard]] std::int64_t net(std::size_t i, BipolarSample sample) const {
+        const std::uint64_t *sign = neuron(i);
+        const std::uint64_t *x = sample.words.data();
+        std::int64_t total = 0;
+        for (std::size_t b = 0; b < planes; ++b) {
+            const std::uint64_t *plane = sign + (b + 1) * words;
+            std::int64_t agree = 0;
+            for (std::size_t k = 0; k < words; ++k) {
+                agree += std::popcount(plane[k] & (x[k] ^ sign[k]));
+            }
+            total += (2 * agree - plane_count[i * planes + b]) << b;
+        }
+        return total + bias[i];
+    }
+};
+
+/**
+  * Planos de bits construídos sob demanda: 'get' os constrói na primeira predição bipolar depois da criação do
+  * modelo ou de 'reset', em vez de a cada treinamento e a cada carga. Assim carregar um modelo não percorre os
+  * pesos, e modelos que nunca recebem entradas bipolares empacotadas nunca pagam pelos planos.
+  *
+  * 'get' pode ser chamado por várias threads ao mesmo tempo: cada uma que encontra o cache vazio constrói os planos
+  * e tenta publicá-los com uma troca atômica; as que perdem a troca descartam os seus e usam os publicados.
+  * 'reset' só pode ser chamado quando nenhuma outra thread usa o cache, como qualquer alteração dos pesos.
+  */
+class BitplaneCache {
+private:
+    mutable std::atomic<const BitplaneWeights *> built{nullptr};
+
+public:
+    BitplaneCache() = default;
+
+    // Uma cópia começa vazia e constrói os seus planos quando precisar
+    BitplaneCache(const BitplaneCache &) {}
+
+    BitplaneCache(BitplaneCache &&other) noexcept : built(other.built.exchange(nullptr)) {}
+
+    BitplaneCache &operator=(const BitplaneCache &) = delete;
+
+    ~BitplaneCache() { delete built.load(); }
+
+    /**
+      * Descarta os planos, que serão reconstruídos na próxima chamada de 'get'. Deve ser chamado sempre que os
+      * pesos mudam.
+      */
+    void reset() { delete built.exchange(nullptr); }
+
+    /**
+      * @param weights Ponteiro para a primeira linha da matriz de pesos (veja 'BitplaneWeights::build').
+      * @param stride Distância entre duas linhas da matriz de pesos.
+      * @param dimension A dimensão dos dados de entrada.
+      * @param num_classes O número de neurônios.
+      * @return Os planos de bits dos pesos atuais; válidos até o próximo 'reset'.
+      */
+    const BitplaneWeights &get(const double *weights, std::size_t stride, std::size_t dimension,
+                               std::size_t num_classes) const {
+        const BitplaneWeights *current = built.load(std::memory_order_acquire);
+        if (current == nullptr) {
+            auto fresh = std::make_unique<BitplaneWeights>();
+            fresh->build(weights, stride, dimension, num_classes);
+            if (built.compare_exchange_strong(current, fresh.get(), std::memory_order_acq_rel,
+                                              std::memory_order_acquire)) {
+                current = fresh.release();
+            }
+        }
+        return *current;
+    }
+};
+
+#endif //SINGLELAYERPERCEPTRON_BIPOLAR_H
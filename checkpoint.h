@@ -0,0 +1,111 @@
+#ifndef SINGLELAYERPERCEPTRON_CHECKPOINT_H
+#define SINGLELAYERPERCEPTRON_CHECKPOINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "mapped_file.h"
+
+/**
+  * Cabeçalho do formato binário de modelos salvos (versão 1).
+  *
+  * O arquivo começa com este cabeçalho de 64 bytes, seguido, a partir de 'weights_offset' (múltiplo de 64 bytes),
+  * da matriz de pesos exatamente como fica na memória: 'num_classes' linhas de 'stride' números decimais, cada uma
+  * com os pesos do neurônio, o peso do bias na posição 'dimension' e o preenchimento até a próxima linha de cache.
+  * Assim o modelo pode ser carregado mapeando o arquivo em memória, sem copiar nem converter os pesos.
+  * Os valores são gravados na ordem de bytes da máquina; 'byte_order' permite detectar um arquivo gravado em uma
+  * máquina com ordem diferente.
+  */
+struct CheckpointHeader {
+    static constexpr char expected_magic[8] = {'S', 'L', 'P', 'M', 'O', 'D', 'E', 'L'};
+    static constexpr std::uint32_t current_version = 1;
+    static constexpr std::uint32_t native_byte_order = 0x01020304;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint64_t dimension;
+    std::uint64_t num_classes;
+    std::uint64_t stride;
+    double learning_rate;
+    double theta;
+    std::uint64_t weights_offset;
+};
+
+static_assert(sizeof(CheckpointHeader) == 64, "o cabecalho do modelo salvo deve ter 64 bytes");
+
+/**
+  * Grava um modelo no formato binário.
+  *
+  * O modelo é gravado em 'filename' + ".tmp", que depois é renomeado para 'filename'. Assim o arquivo antigo nunca
+  * é truncado nem alterado: um modelo carregado dele com 'load' (mapeado em memória, possivelmente pelos próprios
+  * pesos gravados aqui) continua com o conteúdo antigo, e um leitor nunca vê um arquivo incompleto.
+  *
+  * @param filename O caminho do arquivo.
+  * @param header O cabeçalho; 'magic', 'version', 'byte_order' e 'weights_offset' são preenchidos aqui.
+  * @param weights A matriz de pesos, com 'num_classes' * 'stride' elementos.
+  * @throws std::runtime_error se o arquivo não puder ser gravado.
+  */
+inline void writeCheckpoint(const std::string &filename, CheckpointHeader header, const double *weights) {
+    std::memcpy(header.magic, CheckpointHeader::expected_magic, sizeof(header.magic));
+    header.version = CheckpointHeader::current_version;
+    header.byte_order = CheckpointHeader::native_byte_order;
+    header.weights_offset = sizeof(CheckpointHeader);
+
+    const std::string temporary = filename + ".tmp";
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("writeCheckpoint: nao foi possivel criar " + temporary);
+    }
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(weights),
+              static_cast<std::streamsize>(header.num_classes * header.stride * sizeof(double)));
+    out.close();
+    if (!out) {
+        std::remove(temporary.c_str());
+        throw std::runtime_error("writeCheckpoint: erro ao gravar " + temporary);
+    }
+    if (std::rename(temporary.c_str(), filename.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        throw std::runtime_error("writeCheckpoint: nao foi possivel renomear " + temporary + " para " + filename);
+    }
+}
+
+/**
+  * Lê e valida o cabeçalho de um modelo salvo já mapeado em memória.
+  *
+  * @param file O arquivo mapeado.
+  * @param filename O caminho do arquivo, usado nas mensagens de erro.
+  * @return O cabeçalho.
+  * @throws std::runtime_error se o arquivo não estiver no formato esperado.
+  */
+inline CheckpointHeader readCheckpointHeader(const MappedFile &file, const std::string &filename) {
+    CheckpointHeader header{};
+    if (file.size() < sizeof(header)) {
+        throw std::runtime_error("readCheckpointHeader: " + filename + " e menor que o cabecalho");
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, CheckpointHeader::expected_magic, sizeof(header.magic)) != 0) {
+        throw std::runtime_error("readCheckpointHeader: " + filename + " nao e um modelo salvo");
+    }
+    if (header.byte_order != CheckpointHeader::native_byte_order) {
+        throw std::runtime_error("readCheckpointHeader: " + filename + " foi gravado com outra ordem de bytes");
+    }
+    if (header.version != CheckpointHeader::current_version) {
+        throw std::runtime_error("readCheckpointHeader: versao " + std::to_string(header.version) + " de " +
+                                 filename + " nao suportada");
+    }
+    if (header.stride == 0 || header.num_classes > file.size() / header.stride ||
+        header.weights_offset % 64 != 0 || header.weights_offset > file.size() ||
+        header.num_classes * header.stride > (file.size() - header.weights_offset) / sizeof(double)) {
+        throw std::runtime_error("readCheckpointHeader: matriz de pesos invalida em " + filename);
+    }
+    return header;
+}
+
+#endif //SINGLELAYERPERCEPTRON_CHECKPOINT_H
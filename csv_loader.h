@@ -0,0 +1,396 @@
+#ifndef SINGLELAYERPERCEPTRON_CSV_LOADER_H
+#define SINGLELAYERPERCEPTRON_CSV_LOADER_H
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "bipolar.h"
+#include "dataset.h"
+#include "mapped_file.h"
+#include "sparse.h"
+
+/**
+  * Linha malformada encontrada durante a leitura de um CSV.
+  */
+struct CsvError {
+    // Número da linha no arquivo, começando em 1
+    std::size_t line;
+    std::string message;
+};
+
+/**
+  * Conteúdo de um CSV no formato de 'readData': o conjunto de dados lido e as linhas ignoradas.
+  */
+struct CsvData : Dataset {
+    // Linhas ignoradas por estarem malformadas
+    std::vector<CsvError> errors;
+};
+
+namespace csv_detail {
+
+/**
+  * Lê um campo inteiro em [first, last), aceitando espaços ao redor e um sinal '+' opcional.
+  *
+  * @param first Início do campo.
+  * @param last Fim do campo (exclusivo).
+  * @param value Recebe o valor lido.
+  * @return Uma mensagem de erro, ou nullptr se o campo é válido.
+  */
+inline const char *parse_field(const char *first, const char *last, int &value) {
+    while (first < last && (*first == ' ' || *first == '\t')) {
+        ++first;
+    }
+    while (last > first && (last[-1] == ' ' || last[-1] == '\t')) {
+        --last;
+    }
+    if (first < last && *first == '+') {
+        ++first;
+    }
+    if (first == last) {
+        return "campo vazio";
+    }
+    const auto [end, ec] = std::from_chars(first, last, value);
+    if (ec == std::errc::result_out_of_range) {
+        return "valor fora do intervalo de int";
+    }
+    if (ec != std::errc() || end != last) {
+        return "valor nao inteiro";
+    }
+    return nullptr;
+}
+
+/**
+  * Encontra o fim da linha que começa em 'cursor', sem o '\r' de um fim de linha do Windows.
+  *
+  * @param cursor Início da linha.
+  * @param end Fim do arquivo.
+  * @param next Recebe o início da próxima linha.
+  * @return O fim da linha (exclusivo).
+  */
+inline const char *find_line_end(const char *cursor, const char *end, const char *&next) {
+    const void *newline = std::memchr(cursor, '\n', static_cast<std::size_t>(end - cursor));
+    const char *line_end = newline ? static_cast<const char *>(newline) : end;
+    next = newline ? line_end + 1 : end;
+    if (line_end > cursor && line_end[-1] == '\r') {
+        --line_end;
+    }
+    return line_end;
+}
+
+/**
+  * Remove o BOM UTF-8 do início do arquivo.
+  */
+inline void skip_bom(const char *&cursor, const char *end) {
+    if (end - cursor >= 3 && std::memcmp(cursor, "\xEF\xBB\xBF", 3) == 0) {
+        cursor += 3;
+    }
+}
+
+/**
+  * Encontra a primeira linha não vazia com pelo menos 'data_columns' colunas, que define o número de colunas de
+  * saída. As linhas com menos colunas encontradas antes dela são registradas em 'errors'.
+  *
+  * @param cursor Início do arquivo; recebe o início da linha encontrada.
+  * @param end Fim do arquivo.
+  * @param data_columns O número de colunas de dados de cada linha.
+  * @param label_columns Recebe o número de colunas de saída.
+  * @param errors Recebe as linhas malformadas.
+  * @return O número da linha encontrada, ou 0 se não houver nenhuma.
+  */
+inline std::size_t find_first_row(const char *&cursor, const char *end, std::size_t data_columns,
+                                  std::size_t &label_columns, std::vector<CsvError> &errors) {
+    for (std::size_t line = 1; cursor < end; ++line) {
+        const char *next = nullptr;
+        const char *line_end = find_line_end(cursor, end, next);
+        if (line_end != cursor) {
+            const std::size_t columns = static_cast<std::size_t>(std::count(cursor, line_end, ',')) + 1;
+            if (columns >= data_columns) {
+                label_columns = columns - data_columns;
+                return line;
+            }
+            errors.push_back({line, "numero de colunas menor que o numero de colunas de dados"});
+        }
+        cursor = next;
+    }
+    return 0;
+}
+
+/**
+  * Interpreta uma linha não vazia com exatamente 'columns' campos inteiros.
+  *
+  * @param cursor Início da linha.
+  * @param line_end Fim da linha (exclusivo).
+  * @param features Recebe os primeiros 'data_columns' campos.
+  * @param data_columns O número de colunas de dados.
+  * @param labels Recebe os campos restantes.
+  * @param columns O número total de colunas.
+  * @param column Recebe o número de campos lidos com sucesso.
+  * @return Uma mensagem de erro, ou nullptr se a linha é válida.
+  */
+inline const char *parse_row(const char *cursor, const char *line_end, int *features, std::size_t data_columns,
+                             int *labels, std::size_t columns, std::size_t &column) {
+    const char *error = nullptr;
+    column = 0;
+    for (const char *field = cursor;;) {
+        const void *comma = std::memchr(field, ',', static_cast<std::size_t>(line_end - field));
+        const char *field_end = comma ? static_cast<const char *>(comma) : line_end;
+        if (column >= columns) {
+            error = "numero de colunas maior que o da primeira linha";
+            break;
+        }
+        int &value = column < data_columns ? features[column] : labels[column - data_columns];
+        error = parse_field(field, field_end, value);
+        if (error != nullptr) {
+            break;
+        }
+        ++column;
+        if (!comma) {
+            break;
+        }
+        field = field_end + 1;
+    }
+    if (error == nullptr && column < columns) {
+        error = "numero de colunas menor que o da primeira linha";
+    }
+    return error;
+}
+
+} // namespace csv_detail
+
+/**
+  * Lê um CSV no formato de 'readData' mapeando o arquivo em memória e interpretando os campos diretamente
+  * nas páginas mapeadas com std::from_chars.
+  *
+  * O número de linhas é contado antes da leitura para que os buffers sejam alocados uma única vez, e cada campo é
+  * escrito diretamente na sua posição final. O BOM UTF-8 é removido apenas do início do arquivo. O número de
+  * colunas de saída é definido pela primeira linha não vazia com pelo menos 'num_data_columns' colunas.
+  * Linhas vazias são ignoradas; linhas malformadas (campo não inteiro ou número de colunas diferente) são
+  * ignoradas e registradas em 'errors' com o número da linha.
+  *
+  * @param filename O caminho do arquivo CSV.
+  * @param num_data_columns O número de colunas de dados de cada linha.
+  * @return Os dados lidos.
+  * @throws std::runtime_error se o arquivo não puder ser aberto.
+  */
+inline CsvData loadCsv(const std::string &filename, int num_data_columns) {
+    const MappedFile file(filename);
+    const char *cursor = file.data();
+    const char *const end = file.data() + file.size();
+
+    CsvData result;
+    result.data_columns = static_cast<std::size_t>(std::max(num_data_columns, 0));
+    if (file.size() == 0) {
+        return result;
+    }
+
+    csv_detail::skip_bom(cursor, end);
+
+    // Conta as linhas para alocar os buffers uma única vez
+    std::size_t line_count = 0;
+    for (const char *p = cursor; p < end; ++line_count) {
+        const void *newline = std::memchr(p, '\n', static_cast<std::size_t>(end - p));
+        p = newline ? static_cast<const char *>(newline) + 1 : end;
+    }
+
+    // A primeira linha não vazia com colunas suficientes define o número de colunas de saída
+    const std::size_t first_valid = csv_detail::find_first_row(cursor, end, result.data_columns,
+                                                               result.label_columns, result.errors);
+    if (first_valid == 0) {
+        return result;
+    }
+    result.features.resize(line_count * result.data_columns);
+    result.labels.resize(line_count * result.label_columns);
+
+    const std::size_t columns = result.data_columns + result.label_columns;
+    for (std::size_t line = first_valid; cursor < end; ++line) {
+        const char *next = nullptr;
+        const char *line_end = csv_detail::find_line_end(cursor, end, next);
+        if (line_end == cursor) {
+            cursor = next;
+            continue;
+        }
+
+        // Interpreta os campos diretamente nas posições da amostra nos buffers de saída
+        int *features = result.features.data() + result.rows * result.data_columns;
+        int *labels = result.labels.data() + result.rows * result.label_columns;
+        std::size_t column = 0;
+        const char *error = csv_detail::parse_row(cursor, line_end, features, result.data_columns, labels, columns,
+                                                  column);
+
+        // Uma linha malformada não é contada, então a próxima linha sobrescreve o que ela escreveu
+        if (error != nullptr) {
+            result.errors.push_back({line, "coluna " + std::to_string(column + 1) + ": " + error});
+        } else {
+            ++result.rows;
+        }
+        cursor = next;
+    }
+
+    result.features.resize(result.rows * result.data_columns);
+    result.labels.resize(result.rows * result.label_columns);
+    return result;
+}
+
+/**
+  * Pontos de dados esparsos com as saídas desejadas em um único buffer, como em Dataset: a saída desejada da
+  * amostra n ocupa labels[n * label_columns, (n + 1) * label_columns).
+  */
+struct SparseData {
+    std::size_t label_columns = 0;
+    SparseDataset features;
+    std::vector<int> labels;
+
+    [[nodiscard]] std::size_t size() const { return features.size(); }
+
+    [[nodiscard]] std::size_t dimension() const { return features.dimension(); }
+
+    [[nodiscard]] std::size_t label_width() const { return label_columns; }
+
+    /**
+      * @return A saída desejada da amostra n.
+      */
+    [[nodiscard]] std::span<const int> label(std::size_t n) const {
+        return std::span<const int>(labels).subspan(n * label_columns, label_columns);
+    }
+
+    [[nodiscard]] MatrixView<int> label_view() const { return {labels, label_columns}; }
+};
+
+/**
+  * Conteúdo de um CSV no formato de 'readData' com os pontos de dados guardados como um SparseDataset.
+  */
+struct SparseCsvData : SparseData {
+    // Linhas ignoradas por estarem malformadas
+    std::vector<CsvError> errors;
+};
+
+/**
+  * Lê um CSV no formato de 'readData' guardando apenas os valores não nulos dos pontos de dados, sem nunca montar
+  * a matriz densa. Segue as mesmas regras de 'loadCsv' para o BOM, o número de colunas de saída e as linhas
+  * vazias ou malformadas.
+  *
+  * @param filename O caminho do arquivo CSV.
+  * @param num_data_columns O número de colunas de dados de cada linha.
+  * @return Os dados lidos.
+  * @throws std::runtime_error se o arquivo não puder ser aberto.
+  */
+inline SparseCsvData loadSparseCsv(const std::string &filename, int num_data_columns) {
+    const MappedFile file(filename);
+    const char *cursor = file.data();
+    const char *const end = file.data() + file.size();
+
+    const auto data_columns = static_cast<std::size_t>(std::max(num_data_columns, 0));
+    SparseCsvData result;
+    result.features = SparseDataset(data_columns);
+    if (file.size() == 0) {
+        return result;
+    }
+    csv_detail::skip_bom(cursor, end);
+    const std::size_t first_valid = csv_detail::find_first_row(cursor, end, data_columns, result.label_columns,
+                                                               result.errors);
+    if (first_valid == 0) {
+        return result;
+    }
+
+    const std::size_t columns = data_columns + result.label_columns;
+    for (std::size_t line = first_valid; cursor < end; ++line) {
+        const char *next = nullptr;
+        const char *line_end = csv_detail::find_line_end(cursor, end, next);
+        if (line_end == cursor) {
+            cursor = next;
+            continue;
+        }
+
+        const std::size_t label_start = result.labels.size();
+        result.labels.resize(label_start + result.label_columns);
+        const char *error = nullptr;
+        std::size_t column = 0;
+        for (const char *field = cursor;;) {
+            const void *comma = std::memchr(field, ',', static_cast<std::size_t>(line_end - field));
+            const char *field_end = comma ? static_cast<const char *>(comma) : line_end;
+            if (column >= columns) {
+                error = "numero de colunas maior que o da primeira linha";
+                break;
+            }
+            int value = 0;
+            error = csv_detail::parse_field(field, field_end, value);
+            if (error != nullptr) {
+                break;
+            }
+            if (column >= data_columns) {
+                result.labels[label_start + column - data_columns] = value;
+            } else if (value != 0) {
+                result.features.append(static_cast<std::uint32_t>(column), value);
+            }
+            ++column;
+            if (!comma) {
+                break;
+            }
+            field = field_end + 1;
+        }
+        if (error == nullptr && column < columns) {
+            error = "numero de colunas menor que o da primeira linha";
+        }
+
+        if (error != nullptr) {
+            result.errors.push_back({line, "coluna " + std::to_string(column + 1) + ": " + error});
+            result.features.discard_row();
+            result.labels.resize(label_start);
+        } else {
+            result.features.end_row();
+        }
+        cursor = next;
+    }
+    return result;
+}
+
+/**
+  * Lê os dados de um arquivo CSV: as primeiras 'num_data_columns' colunas de cada linha são o ponto de dados
+  * e as demais são a saída desejada. A leitura é feita por 'loadCsv' (veja csv_loader.h); linhas malformadas são
+  * ignoradas e informadas em std::cerr com o seu número.
+  *
+  * @param filename O caminho do arquivo CSV.
+  * @param num_data_columns O número de colunas de dados de cada linha.
+  * @param packed Se não for nulo e todas as colunas de dados forem bipolares (-1 ou +1), recebe os pontos de dados
+  *               empacotados; caso contrário fica vazio.
+  * @return Os pontos de dados e as saídas desejadas, nos buffers contíguos preenchidos por 'loadCsv', sem cópia.
+  */
+inline Dataset readData(const std::string &filename, int num_data_columns, PackedBipolarDataset *packed = nullptr) {
+    CsvData csv = loadCsv(filename, num_data_columns);
+    for (const auto &error: csv.errors) {
+        std::cerr << filename << ":" << error.line << ": " << error.message << std::endl;
+    }
+
+    // Detecta se todas as colunas de dados são bipolares e, nesse caso, empacota os pontos de dados
+    if (packed != nullptr && !PackedBipolarDataset::pack(csv.features, csv.data_columns, *packed)) {
+        *packed = PackedBipolarDataset();
+    }
+
+    return std::move(static_cast<Dataset &>(csv));
+}
+
+/**
+  * Versão de 'readData' para pontos de dados esparsos (veja 'loadSparseCsv').
+  *
+  * @param filename O caminho do arquivo CSV.
+  * @param num_data_columns O número de colunas de dados de cada linha.
+  * @return Os pontos de dados esparsos e as saídas desejadas, no buffer contíguo preenchido por 'loadSparseCsv',
+  *         sem cópia; 'label_view()' pode ser passado diretamente a 'train'.
+  */
+inline SparseData readSparseData(const std::string &filename, int num_data_columns) {
+    SparseCsvData csv = loadSparseCsv(filename, num_data_columns);
+    for (const auto &error: csv.errors) {
+        std::cerr << filename << ":" << error.line << ": " << error.message << std::endl;
+    }
+    return std::move(static_cast<SparseData &>(csv));
+}
+
+#endif //SINGLELAYERPERCEPTRON_CSV_LOADER_H
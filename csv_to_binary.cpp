@@ -0,0 +1,40 @@
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <string>
+
+#include "binary_dataset.h"
+#include "csv_loader.h"
+
+/**
+  * Converte um CSV no formato de 'readData' para o formato binário de conjuntos de dados (veja binary_dataset.h).
+  *
+  * Uso: csv_to_binary <entrada.csv> <colunas_de_dados> <saida.bin> [--int32]
+  *
+  * Por padrão, conjuntos em que todos os pontos de dados são bipolares são gravados empacotados;
+  * --int32 força a gravação como int32.
+  */
+int main(int argc, char *argv[]) {
+    if (argc != 4 && !(argc == 5 && std::strcmp(argv[4], "--int32") == 0)) {
+        std::cerr << "Uso: " << argv[0] << " <entrada.csv> <colunas_de_dados> <saida.bin> [--int32]" << std::endl;
+        return 2;
+    }
+
+    try {
+        const CsvData csv = loadCsv(argv[1], std::stoi(argv[2]));
+        for (const auto &error: csv.errors) {
+            std::cerr << argv[1] << ":" << error.line << ": " << error.message << std::endl;
+        }
+
+        writeBinaryDataset(csv, argv[3], argc == 4);
+
+        const BinaryDataset written(argv[3]);
+        std::cout << argv[3] << ": " << written.size() << " amostras, dimensao " << written.dimension()
+                  << ", " << written.label_width() << " saidas, elementos "
+                  << (written.is_bipolar() ? "bipolares empacotados" : "int32") << std::endl;
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,129 @@
+#ifndef SINGLELAYERPERCEPTRON_CYCLE_DETECTOR_H
+#define SINGLELAYERPERCEPTRON_CYCLE_DETECTOR_H
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "bipolar.h"
+#include "random.h"
+#include "sparse.h"
+
+/**
+  * Detecta ciclos nos pesos de um treinamento que não converge.
+  *
+  * Os pesos de um neurônio são sempre os pesos iniciais mais learning_rate vezes uma soma de pontos de dados com
+  * sinal (veja 'ch_weights'), então o estado do neurônio é determinado pelo vetor de inteiros c dessa soma (com o
+  * bias). O detector mantém, para cada neurônio, o hash linear H = soma_j r_j * c_j (mod 2^64) com coeficientes
+  * r_j aleatórios. Como o hash é linear, cada atualização dos pesos só soma +-h(x) ao hash do neurônio, onde h(x)
+  * é o hash do ponto de dados, calculado uma única vez por amostra; a matriz de pesos nunca é percorrida.
+  *
+  * Como 'internal_train' percorre as amostras sempre na mesma ordem, se o estado no fim de uma época já ocorreu
+  * no fim de uma época anterior, o treinamento com aritmética exata repete o mesmo ciclo de épocas para sempre.
+  * Dois estados distintos têm o mesmo hash com probabilidade de cerca de 2^-64 por par de épocas.
+  *
+  * O estado c só determina os pesos calculados quando cada atualização é exata: taxa de aprendizado inteira, pesos
+  * iniciais inteiros (como os de um modelo novo, mas não necessariamente os de um modelo carregado) e pesos abaixo
+  * de 2^53 em módulo. Com uma taxa fracionária, como 0.1, os pesos double acumulam erros de arredondamento que
+  * dependem do caminho, então um ciclo informado é o do treinamento com aritmética exata: os pesos calculados só
+  * voltam aproximadamente ao estado anterior e o treinamento real poderia, em princípio, sair do ciclo. Pesos que
+  * saturam (FixedSingleLayerPerceptron com pesos inteiros) deixam de ser os pesos iniciais mais uma soma de pontos
+  * de dados, por isso esse modelo rejeita a detecção de ciclos.
+  */
+class CycleDetector {
+private:
+    // r_j de cada coluna; o coeficiente do bias fica na posição 'dimension'
+    std::vector<std::uint64_t> coefficients;
+    // h(x) de cada amostra do conjunto de treinamento
+    std::vector<std::uint64_t> sample_hashes;
+    // H de cada neurônio
+    std::vector<std::uint64_t> row_hashes;
+    // Época em que cada estado foi visto pela primeira vez
+    std::unordered_map<std::uint64_t, std::size_t> seen;
+
+    [[nodiscard]] std::uint64_t hash(std::span<const int> data) const {
+        std::uint64_t h = coefficients.back();
+        for (std::size_t j = 0; j < data.size(); ++j) {
+            h += coefficients[j] * static_cast<std::uint64_t>(static_cast<std::int64_t>(data[j]));
+        }
+        return h;
+    }
+
+    [[nodiscard]] std::uint64_t hash(BipolarSample data) const {
+        // Cada valor é +1 (bit 1) ou -1 (bit 0)
+        std::uint64_t h = coefficients.back();
+        for (std::size_t j = 0; j + 1 < coefficients.size(); ++j) {
+            const bool positive = (data.words[j / 64] >> (j % 64)) & 1u;
+            h += positive ? coefficients[j] : -coefficients[j];
+        }
+        return h;
+    }
+
+    [[nodiscard]] std::uint64_t hash(SparseSample data) const {
+        std::uint64_t h = coefficients.back();
+        for (std::size_t k = 0; k < data.nnz(); ++k) {
+            h += coefficients[data.indices[k]] * static_cast<std::uint64_t>(static_cast<std::int64_t>(data.values[k]));
+        }
+        return h;
+    }
+
+    /**
+      * Combina os hashes dos neurônios em um hash do estado de toda a matriz de pesos.
+      */
+    [[nodiscard]] std::uint64_t state() const {
+        std::uint64_t combined = 0;
+        for (std::size_t i = 0; i < row_hashes.size(); ++i) {
+            combined = std::rotl(combined, 5) ^ SplitMix64::derive(row_hashes[i], i);
+        }
+        return combined;
+    }
+
+public:
+    /**
+      * Prepara o detector para um treinamento, calculando o hash de cada amostra.
+      *
+      * @param dataset Os dados de treinamento (veja 'internal_train').
+      * @param dimension A dimensão dos dados de entrada.
+      * @param num_classes O número de neurônios.
+      */
+    template<typename Dataset>
+    CycleDetector(const Dataset &dataset, std::size_t dimension, std::size_t num_classes)
+            : coefficients(dimension + 1), row_hashes(num_classes, 0) {
+        SplitMix64 rng(0x5EED5EED5EED5EEDULL);
+        for (auto &r: coefficients) {
+            r = rng() | 1u;
+        }
+        sample_hashes.reserve(dataset.size());
+        for (std::size_t n = 0; n < dataset.size(); ++n) {
+            sample_hashes.push_back(hash(dataset[n]));
+        }
+        seen.emplace(state(), 0);
+    }
+
+    /**
+      * Registra uma atualização dos pesos de um neurônio.
+      *
+      * @param i O índice do neurônio.
+      * @param n O índice da amostra que causou a atualização.
+      * @param target A saída desejada da amostra, que dá o sinal da atualização.
+      */
+    void record_update(std::size_t i, std::size_t n, int target) {
+        row_hashes[i] += static_cast<std::uint64_t>(static_cast<std::int64_t>(target)) * sample_hashes[n];
+    }
+
+    /**
+      * Registra o estado ao fim de uma época.
+      *
+      * @param epoch O número da época.
+      * @return O comprimento do ciclo, em épocas, se o estado já ocorreu antes; caso contrário 0.
+      */
+    std::size_t end_epoch(std::size_t epoch) {
+        const auto [it, inserted] = seen.emplace(state(), epoch);
+        return inserted ? 0 : epoch - it->second;
+    }
+};
+
+#endif //SINGLELAYERPERCEPTRON_CYCLE_DETECTOR_H
@@ -0,0 +1,62 @@
+#ifndef SINGLELAYERPERCEPTRON_DATASET_H
+#define SINGLELAYERPERCEPTRON_DATASET_H
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+/**
+  * Visão somente leitura de uma matriz guardada linha a linha em um único buffer.
+  * Acessar a linha n devolve um std::span sobre os seus 'cols' elementos, sem cópia.
+  */
+template<typename T>
+struct MatrixView {
+    std::span<const T> values;
+    std::size_t cols = 0;
+
+    [[nodiscard]] std::size_t size() const { return cols == 0 ? 0 : values.size() / cols; }
+
+    std::span<const T> operator[](std::size_t n) const { return values.subspan(n * cols, cols); }
+};
+
+/**
+  * Conjunto de dados em dois buffers contíguos, em vez de um vetor por amostra.
+  * O ponto de dados da amostra n ocupa features[n * data_columns, (n + 1) * data_columns) e a sua saída desejada
+  * ocupa labels[n * label_columns, (n + 1) * label_columns).
+  *
+  * Acessar dataset[n] devolve o ponto de dados n como um std::span, então o conjunto pode ser usado diretamente
+  * onde se espera um vetor 2D de pontos de dados (veja 'SingleLayerPerceptron::internal_train').
+  */
+struct Dataset {
+    std::size_t rows = 0;
+    std::size_t data_columns = 0;
+    std::size_t label_columns = 0;
+    std::vector<int> features;
+    std::vector<int> labels;
+
+    [[nodiscard]] std::size_t size() const { return rows; }
+
+    [[nodiscard]] std::size_t dimension() const { return data_columns; }
+
+    [[nodiscard]] std::size_t label_width() const { return label_columns; }
+
+    /**
+      * @return O ponto de dados da amostra n.
+      */
+    std::span<const int> operator[](std::size_t n) const {
+        return std::span<const int>(features).subspan(n * data_columns, data_columns);
+    }
+
+    /**
+      * @return A saída desejada da amostra n.
+      */
+    [[nodiscard]] std::span<const int> label(std::size_t n) const {
+        return std::span<const int>(labels).subspan(n * label_columns, label_columns);
+    }
+
+    [[nodiscard]] MatrixView<int> feature_view() const { return {features, data_columns}; }
+
+    [[nodiscard]] MatrixView<int> label_view() const { return {labels, label_columns}; }
+};
+
+#endif //SINGLELAYERPERCEPTRON_DATASET_H
@@ -0,0 +1,86 @@
+#ifndef SINGLELAYERPERCEPTRON_EPOCH_ORDER_H
+#define SINGLELAYERPERCEPTRON_EPOCH_ORDER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "random.h"
+
+/**
+  * Ordem em que as amostras são visitadas em cada época de um treinamento embaralhado.
+  *
+  * Em vez de mover as amostras, guarda uma permutação dos seus índices, refeita no início de cada época com o
+  * algoritmo de Fisher-Yates a partir de um fluxo aleatório derivado da semente e do número da época; a mesma
+  * semente produz sempre as mesmas ordens.
+  *
+  * Com blocos, as amostras são divididas em blocos de 'block' amostras consecutivas: a ordem dos blocos é
+  * embaralhada e as amostras são embaralhadas apenas dentro de cada bloco, então cada trecho da época lê uma região
+  * contígua do conjunto de dados.
+  */
+class EpochOrder {
+private:
+    std::vector<std::size_t> indices;
+    std::vector<std::size_t> blocks;
+    std::uint64_t seed;
+    std::size_t block;
+
+    /**
+      * Embaralha um intervalo com o algoritmo de Fisher-Yates.
+      */
+    static void shuffle(std::span<std::size_t> values, SplitMix64 &rng) {
+        for (std::size_t k = values.size(); k > 1; --k) {
+            std::swap(values[k - 1], values[rng.below(k)]);
+        }
+    }
+
+public:
+    /**
+      * @param size O número de amostras.
+      * @param seed A semente das permutações.
+      * @param block O número de amostras de cada bloco; 0 embaralha todas as amostras livremente.
+      */
+    EpochOrder(std::size_t size, std::uint64_t seed, std::size_t block = 0)
+            : indices(size), seed(seed), block(block) {
+        if (block != 0) {
+            blocks.resize((size + block - 1) / block);
+        }
+    }
+
+    /**
+      * Sorteia a ordem de uma época.
+      *
+      * @param epoch O número da época.
+      */
+    void shuffle(std::size_t epoch) {
+        SplitMix64 rng(SplitMix64::derive(seed, epoch));
+        if (block == 0) {
+            std::iota(indices.begin(), indices.end(), std::size_t{0});
+            shuffle(indices, rng);
+            return;
+        }
+
+        std::iota(blocks.begin(), blocks.end(), std::size_t{0});
+        shuffle(blocks, rng);
+        std::size_t position = 0;
+        for (const std::size_t b: blocks) {
+            const std::size_t first = b * block;
+            const std::size_t count = std::min(block, indices.size() - first);
+            const std::span<std::size_t> part(indices.data() + position, count);
+            std::iota(part.begin(), part.end(), first);
+            shuffle(part, rng);
+            position += count;
+        }
+    }
+
+    /**
+      * @return A ordem da época atual: a posição k da época visita a amostra order()[k].
+      */
+    [[nodiscard]] std::span<const std::size_t> order() const { return indices; }
+};
+
+#endif //SINGLELAYERPERCEPTRON_EPOCH_ORDER_H
@@ -0,0 +1,356 @@
+#ifndef SINGLELAYERPERCEPTRON_FIXED_SINGLE_LAYER_PERCEPTRON_H
+#define SINGLELAYERPERCEPTRON_FIXED_SINGLE_LAYER_PERCEPTRON_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "cycle_detector.h"
+#include "kernels.h"
+#include "training.h"
+
+// Sem FMA, como nos kernels (veja kernels.h)
+SLP_FP_CONTRACT_OFF_BEGIN
+
+/**
+  * Variante de SingleLayerPerceptron com a dimensão e o número de classes conhecidos em tempo de compilação.
+  *
+  * Os pesos ficam em um std::array dentro do próprio objeto (na pilha, se o objeto estiver na pilha), e todos os
+  * laços sobre a dimensão e sobre as classes têm um número de iterações constante, então o compilador pode
+  * desenrolá-los e vetorizá-los para a forma exata do modelo, sem escolher kernels em tempo de execução.
+  *
+  * O produto escalar usa as mesmas 'kernels::lanes' somas parciais e a mesma ordem de 'kernels::reduce' que os
+  * kernels de SingleLayerPerceptron, sem FMA, então os dois modelos produzem pesos e previsões idênticos bit a bit.
+  * Quando a forma só é conhecida em tempo de execução, SingleLayerPerceptron oferece a mesma interface.
+  *
+  * Com Weight igual a std::int16_t ou std::int32_t, os pesos e os bias são inteiros: a taxa de aprendizado deve
+  * ser inteira, o produto escalar é acumulado exatamente em std::int64_t e comparado com limiares inteiros
+  * equivalentes a theta, então o resultado é exato e igual em qualquer máquina. Enquanto nenhum peso sai do
+  * intervalo de Weight, os pesos e as previsões são os mesmos do modelo com pesos double (para entradas e taxa de
+  * aprendizado inteiras). Uma atualização que sairia do intervalo satura o peso no limite de Weight e é contada em
+  * 'saturations'; a partir daí o modelo deixa de ser exato. Para que a entrada líquida nunca transborde
+  * std::int64_t, os valores de entrada devem estar em [-input_limit, input_limit]; com std::int16_t o limite é
+  * INT_MAX até Dim = 131072, e com std::int32_t ele cai com Dim (cerca de 2^32 / Dim).
+  *
+  * @tparam Dim A dimensão dos dados de entrada.
+  * @tparam Classes O número de classes (neurônios).
+  * @tparam Weight O tipo dos pesos: double, std::int16_t ou std::int32_t.
+  */
+template<std::size_t Dim, std::size_t Classes, typename Weight = double>
+class FixedSingleLayerPerceptron {
+    static_assert(Dim > 0 && Classes > 0, "a dimensao e o numero de classes devem ser positivos");
+    static_assert(std::is_same_v<Weight, double> || std::is_same_v<Weight, std::int16_t> ||
+                  std::is_same_v<Weight, std::int32_t>, "os pesos devem ser double, int16_t ou int32_t");
+
+public:
+    static constexpr std::size_t dimension = Dim;
+    static constexpr std::size_t num_classes = Classes;
+    using weight_type = Weight;
+
+private:
+    static constexpr bool integral = std::is_integral_v<Weight>;
+
+public:
+    /**
+      * Maior módulo de um valor de entrada com pesos inteiros. Sendo w o módulo do menor valor de Weight, a entrada
+      * líquida tem módulo no máximo Dim * input_limit * w + w, que cabe em std::int64_t, então o produto escalar
+      * inteiro nunca transborda. Com pesos double, as entradas não são limitadas.
+      */
+    static constexpr std::int64_t input_limit = [] {
+        constexpr std::int64_t int_max = std::numeric_limits<int>::max();
+        if constexpr (!integral) {
+            return int_max;
+        } else {
+            constexpr std::int64_t w = -static_cast<std::int64_t>(std::numeric_limits<Weight>::min());
+            constexpr std::int64_t fits = (std::numeric_limits<std::int64_t>::max() - w) /
+                                          (static_cast<std::int64_t>(Dim) * w);
+            return std::min(fits, int_max);
+        }
+    }();
+    static_assert(input_limit >= 1, "a dimensao e grande demais para acumular a entrada liquida em int64_t");
+
+private:
+    // Acesso aos pesos para compará-los nos testes (veja tests.cpp)
+    friend struct PerceptronTest;
+
+    // Mesma disposição de SingleLayerPerceptron: cada linha guarda os pesos, o bias na posição Dim e o
+    // preenchimento até a próxima linha de cache
+    static constexpr std::size_t per_line = 64 / sizeof(Weight);
+    static constexpr std::size_t stride = (Dim + 1 + per_line - 1) / per_line * per_line;
+
+    alignas(64) std::array<Weight, Classes * stride> weights{};
+    double learning_rate;
+    double theta;
+
+    // Pesos inteiros: a taxa de aprendizado inteira e os limiares inteiros equivalentes a theta. Para uma entrada
+    // líquida inteira, net > theta equivale a net >= floor(theta) + 1 e net >= theta - 1 a net >= ceil(theta - 1).
+    std::int64_t step = 0;
+    std::int64_t upper_threshold = 0;
+    std::int64_t lower_threshold = 0;
+
+    // Número de atualizações de pesos inteiros que saturaram no limite de Weight
+    std::size_t saturated = 0;
+
+    [[nodiscard]] int activation(double net) const {
+        return (net > theta) ? 1 : ((net >= theta - 1) ? 0 : -1);
+    }
+
+    [[nodiscard]] int activation(std::int64_t net) const {
+        return (net >= upper_threshold) ? 1 : ((net >= lower_threshold) ? 0 : -1);
+    }
+
+    [[nodiscard]] const Weight *row(std::size_t i) const { return weights.data() + i * stride; }
+
+    [[nodiscard]] Weight *row(std::size_t i) { return weights.data() + i * stride; }
+
+    /**
+      * @return Verdadeiro se os pesos forem double ou se todos os valores do ponto de dados estiverem em
+      *         [-input_limit, input_limit].
+      */
+    [[nodiscard]] static bool in_range(const std::vector<int> &data) {
+        if constexpr (!integral) {
+            return true;
+        }
+        return std::all_of(data.begin(), data.end(), [](int value) {
+            return value >= -input_limit && value <= input_limit;
+        });
+    }
+
+    /**
+      * Calcula a saída da função de ativação de um neurônio (veja SingleLayerPerceptron::act_func).
+      *
+      * @param data Um ponto de dados com exatamente Dim valores.
+      * @param row Ponteiro para a linha da matriz de pesos do neurônio; o bias fica na posição Dim.
+      * @return Um inteiro representando a saída da função de ativação.
+      */
+    [[nodiscard]] SLP_NO_FMA int act_func(std::span<const int, Dim> data, const Weight *row) const {
+        if constexpr (integral) {
+            // A soma inteira é exata em qualquer ordem, então o compilador pode reordená-la livremente; com as
+            // entradas em [-input_limit, input_limit] ela nunca transborda
+            std::int64_t net = row[Dim];
+            for (std::size_t j = 0; j < Dim; ++j) {
+                net += static_cast<std::int64_t>(data[j]) * row[j];
+            }
+            return activation(net);
+        } else {
+            double partial[kernels::lanes] = {};
+            for (std::size_t j = 0; j < Dim; ++j) {
+                partial[j % kernels::lanes] += data[j] * row[j];
+            }
+            return activation(row[Dim] + kernels::reduce(partial));
+        }
+    }
+
+    /**
+      * Atualiza os pesos e o bias de um neurônio (veja SingleLayerPerceptron::ch_weights).
+      *
+      * @param data Um ponto de dados com exatamente Dim valores.
+      * @param target Um inteiro representando a saída real para o ponto de dado.
+      * @param output Um inteiro representando a saída prevista para o ponto de dado.
+      * @param row Ponteiro para a linha da matriz de pesos do neurônio; o bias fica na posição Dim.
+      * @return Verdadeiro se os pesos foram atualizados.
+      */
+    SLP_NO_FMA bool ch_weights(std::span<const int, Dim> data, int target, int output, Weight *row) {
+        if (output != target && learning_rate != 0 && target != 0) {
+            if constexpr (integral) {
+                constexpr std::int64_t min = std::numeric_limits<Weight>::min();
+                constexpr std::int64_t max = std::numeric_limits<Weight>::max();
+                // 'train' só aceita saídas desejadas em {-1, 0, 1} e |step| cabe em Weight, então |scale * data[j]|
+                // é no máximo 2^31 * 2^31 e a atualização não transborda
+                const std::int64_t scale = step * target;
+                std::size_t clipped = 0;
+                for (std::size_t j = 0; j <= Dim; ++j) {
+                    const std::int64_t value = row[j] + scale * (j < Dim ? data[j] : 1);
+                    const std::int64_t clamped = std::clamp(value, min, max);
+                    clipped += clamped != value;
+                    row[j] = static_cast<Weight>(clamped);
+                }
+                saturated += clipped;
+            } else {
+                const double scale = learning_rate * target;
+                for (std::size_t j = 0; j < Dim; ++j) {
+                    row[j] = row[j] + scale * data[j];
+                }
+                row[Dim] += scale;
+            }
+            return true;
+        }
+        return false;
+    }
+
+    /**
+      * Executa uma época de treinamento (veja SingleLayerPerceptron::internal_train).
+      *
+      * @param dataset Os pontos de dados, cada um com Dim valores.
+      * @param target A saída desejada para cada ponto de dados, com Classes valores.
+      * @param cycles Se não for nulo, recebe as atualizações dos pesos para detectar ciclos.
+      * @param order A ordem em que as amostras são visitadas; vazia visita na ordem do dataset.
+      * @return As estatísticas da época, sem o número da época e o tempo decorrido.
+      */
+    SLP_NO_FMA EpochStats internal_train(const std::vector<std::vector<int>> &dataset,
+                                         const std::vector<std::vector<int>> &target,
+                                         CycleDetector *cycles, std::span<const std::size_t> order) {
+        EpochStats stats;
+        stats.evaluations = dataset.size() * Classes;
+        for (std::size_t k = 0; k < dataset.size(); ++k) {
+            const std::size_t n = order.empty() ? k : order[k];
+            const std::span<const int, Dim> data(dataset[n].data(), Dim);
+            const std::vector<int> &expected = target[n];
+            for (std::size_t i = 0; i < Classes; ++i) {
+                const int output = act_func(data, row(i));
+                if (ch_weights(data, expected[i], output, row(i))) {
+                    ++stats.updates;
+                    if (cycles != nullptr) {
+                        cycles->record_update(i, n, expected[i]);
+                    }
+                }
+                stats.misclassifications += output != expected[i];
+            }
+        }
+        return stats;
+    }
+
+public:
+    /**
+      * @param learning_rate A taxa de aprendizado; deve ser inteira quando os pesos são inteiros.
+      * @param theta O limiar da função de ativação.
+      * @throws std::invalid_argument se os pesos forem inteiros e a taxa de aprendizado não for inteira ou não
+      *         couber em Weight, ou se theta não for finito.
+      */
+    FixedSingleLayerPerceptron(double learning_rate, double theta) : learning_rate(learning_rate), theta(theta) {
+        if constexpr (integral) {
+            if (learning_rate != std::trunc(learning_rate) ||
+                std::fabs(learning_rate) > static_cast<double>(std::numeric_limits<Weight>::max())) {
+                throw std::invalid_argument("FixedSingleLayerPerceptron: a taxa de aprendizado de pesos inteiros "
+                                            "deve ser um inteiro representavel no tipo dos pesos");
+            }
+            if (!std::isfinite(theta) || std::fabs(theta) > 4e18) {
+                throw std::invalid_argument("FixedSingleLayerPerceptron: theta invalido para pesos inteiros");
+            }
+            step = static_cast<std::int64_t>(learning_rate);
+            upper_threshold = static_cast<std::int64_t>(std::floor(theta)) + 1;
+            lower_threshold = static_cast<std::int64_t>(std::ceil(theta - 1));
+        }
+    }
+
+    /**
+      * Número de atualizações de pesos inteiros que saturaram no limite de Weight desde a criação do modelo.
+      * Se for maior que zero, os pesos deixaram de ser os mesmos do modelo com pesos double.
+      */
+    [[nodiscard]] std::size_t saturations() const { return saturated; }
+
+    /**
+      * Treina o modelo (veja SingleLayerPerceptron::train).
+      *
+      * @param dataset Um vetor 2D de números inteiros com os pontos de dados, cada um com Dim valores.
+      * @param target Um vetor 2D de números inteiros com a saída desejada de cada ponto de dados, com Classes valores.
+      * @param options Os limites e o callback do treinamento; por padrão, treina até convergir.
+      * @return O motivo da parada e as estatísticas da última época.
+      * @throws std::invalid_argument se algum ponto de dados ou saída desejada tiver o tamanho errado, se algum
+      *         valor de entrada estiver fora de [-input_limit, input_limit], se alguma saída desejada não for -1, 0
+      *         ou 1 (as saídas possíveis da função de ativação), se 'options.average' for pedido (os pesos médios
+      *         não são inteiros) ou se 'options.detect_cycles' for pedido com pesos inteiros, que podem saturar e
+      *         deixar de corresponder ao estado acompanhado pelo detector (veja cycle_detector.h).
+      */
+    TrainResult train(const std::vector<std::vector<int>> &dataset, const std::vector<std::vector<int>> &target,
+                      const TrainOptions &options = {}) {
+        if (options.average) {
+            throw std::invalid_argument("train: o perceptron medio nao e suportado pelo modelo com forma fixa");
+        }
+        if (integral && options.detect_cycles) {
+            throw std::invalid_argument("train: detect_cycles nao e suportado com pesos inteiros, que saturam");
+        }
+        if (target.size() != dataset.size()) {
+            throw std::invalid_argument("train: o numero de saidas desejadas difere do numero de pontos de dados");
+        }
+        for (std::size_t n = 0; n < dataset.size(); ++n) {
+            if (dataset[n].size() != Dim || target[n].size() != Classes) {
+                throw std::invalid_argument("train: ponto de dados ou saida desejada com tamanho diferente do modelo");
+            }
+            if (!in_range(dataset[n])) {
+                throw std::invalid_argument("train: valor de entrada fora do intervalo dos pesos inteiros");
+            }
+            if (!std::all_of(target[n].begin(), target[n].end(),
+                             [](int value) { return value >= -1 && value <= 1; })) {
+                throw std::invalid_argument("train: saida desejada diferente de -1, 0 e 1");
+            }
+        }
+        return run_epochs(dataset, Dim, Classes, options,
+                          [&](CycleDetector *cycles, std::span<const std::size_t> order) {
+                              return internal_train(dataset, target, cycles, order);
+                          });
+    }
+
+    /**
+      * Faz a previsão de um ponto de dados sem alocar memória.
+      *
+      * @param data Um ponto de dados com exatamente Dim valores; com pesos inteiros, em [-input_limit, input_limit],
+      *             o que não é verificado.
+      * @return As saídas da função de ativação de cada neurônio.
+      */
+    SLP_NO_FMA std::array<int, Classes> predict(std::span<const int, Dim> data) const {
+        std::array<int, Classes> output{};
+        for (std::size_t i = 0; i < Classes; ++i) {
+            output[i] = act_func(data, row(i));
+        }
+        return output;
+    }
+
+    /**
+      * Faz a previsão de um ponto de dados, com a mesma interface de SingleLayerPerceptron::predict.
+      *
+      * @param data Um vetor de inteiros com Dim valores.
+      * @return Um vetor com as saídas da função de ativação de cada neurônio.
+      * @throws std::invalid_argument se o ponto de dados não tiver Dim valores ou algum valor estiver fora de
+      *         [-input_limit, input_limit].
+      */
+    std::vector<int> predict(const std::vector<int> &data) const {
+        if (data.size() != Dim) {
+            throw std::invalid_argument("predict: a dimensao do ponto de dados difere da do modelo");
+        }
+        if (!in_range(data)) {
+            throw std::invalid_argument("predict: valor de entrada fora do intervalo dos pesos inteiros");
+        }
+        const std::array<int, Classes> output = predict(std::span<const int, Dim>(data.data(), Dim));
+        return {output.begin(), output.end()};
+    }
+
+    /**
+      * Faz a previsão de um conjunto de pontos de dados.
+      *
+      * @param dataset Um vetor 2D de números inteiros com os pontos de dados.
+      * @return Um vetor 2D com as saídas da função de ativação para cada ponto de dados.
+      */
+    std::vector<std::vector<int>> predict_batch(const std::vector<std::vector<int>> &dataset) const {
+        std::vector<std::vector<int>> output;
+        output.reserve(dataset.size());
+        for (const auto &data: dataset) {
+            output.push_back(predict(data));
+        }
+        return output;
+    }
+
+    void print_weights() const {
+        for (std::size_t i = 0; i < Classes; ++i) {
+            const Weight *weight = row(i);
+            std::cout << "Neuronio " << i + 1 << ":" << std::endl;
+            std::cout << "Peso: ";
+            std::copy(weight, weight + Dim, std::ostream_iterator<double>(std::cout, ", "));
+            std::cout << std::endl;
+            std::cout << "Peso do bias: " << weight[Dim] << std::endl;
+        }
+    }
+};
+
+SLP_FP_CONTRACT_OFF_END
+
+#endif //SINGLELAYERPERCEPTRON_FIXED_SINGLE_LAYER_PERCEPTRON_H
@@ -0,0 +1,118 @@
+#ifndef SINGLELAYERPERCEPTRON_GRAM_MATRIX_H
+#define SINGLELAYERPERCEPTRON_GRAM_MATRIX_H
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "bipolar.h"
+#include "sparse.h"
+
+namespace gram_detail {
+
+/**
+  * Produto escalar exato entre dois pontos de dados do mesmo tipo.
+  */
+inline std::int64_t dot(std::span<const int> a, std::span<const int> b, std::size_t dimension) {
+    std::int64_t sum = 0;
+    for (std::size_t j = 0; j < dimension; ++j) {
+        sum += static_cast<std::int64_t>(a[j]) * b[j];
+    }
+    return sum;
+}
+
+inline std::int64_t dot(BipolarSample a, BipolarSample b, std::size_t dimension) {
+    // Cada valor diferente contribui -1 e cada valor igual +1; os bits além da dimensão são 0 nas duas amostras
+    std::int64_t different = 0;
+    for (std::size_t w = 0; w < a.words.size(); ++w) {
+        different += std::popcount(a.words[w] ^ b.words[w]);
+    }
+    return static_cast<std::int64_t>(dimension) - 2 * different;
+}
+
+inline std::int64_t dot(SparseSample a, SparseSample b, std::size_t) {
+    // Os índices estão em ordem crescente, então basta intercalar as duas listas
+    std::int64_t sum = 0;
+    std::size_t p = 0;
+    std::size_t q = 0;
+    while (p < a.nnz() && q < b.nnz()) {
+        if (a.indices[p] < b.indices[q]) {
+            ++p;
+        } else if (b.indices[q] < a.indices[p]) {
+            ++q;
+        } else {
+            sum += static_cast<std::int64_t>(a.values[p++]) * b.values[q++];
+        }
+    }
+    return sum;
+}
+
+/**
+  * Soma coefficient * data a um vetor de inteiros com 'dimension' posições.
+  */
+inline void accumulate(std::span<const int> data, std::int64_t coefficient, std::int64_t *sum, std::size_t dimension) {
+    for (std::size_t j = 0; j < dimension; ++j) {
+        sum[j] += coefficient * data[j];
+    }
+}
+
+inline void accumulate(BipolarSample data, std::int64_t coefficient, std::int64_t *sum, std::size_t dimension) {
+    for (std::size_t j = 0; j < dimension; ++j) {
+        sum[j] += ((data.words[j / 64] >> (j % 64)) & 1u) ? coefficient : -coefficient;
+    }
+}
+
+inline void accumulate(SparseSample data, std::int64_t coefficient, std::int64_t *sum, std::size_t) {
+    for (std::size_t k = 0; k < data.nnz(); ++k) {
+        sum[data.indices[k]] += coefficient * data.values[k];
+    }
+}
+
+} // namespace gram_detail
+
+/**
+  * Matriz de Gram K(m, n) = x_m . x_n de um conjunto de dados, calculada de forma exata com inteiros.
+  * As linhas são calculadas apenas na primeira vez em que são pedidas: no treinamento na forma dual só as
+  * amostras que causam alguma atualização dos pesos precisam da sua linha.
+  *
+  * @tparam Dataset Um vetor 2D de números inteiros, um PackedBipolarDataset, um SparseDataset ou uma visão dos
+  *                 pontos de dados de um Dataset ou BinaryDataset.
+  */
+template<typename Dataset>
+class GramMatrix {
+private:
+    const Dataset &dataset;
+    std::size_t dimension;
+    std::vector<std::vector<std::int64_t>> rows;
+
+public:
+    /**
+      * @param dataset Os pontos de dados; devem continuar válidos enquanto a matriz for usada.
+      * @param dimension A dimensão dos pontos de dados.
+      */
+    GramMatrix(const Dataset &dataset, std::size_t dimension)
+            : dataset(dataset), dimension(dimension), rows(dataset.size()) {}
+
+    /**
+      * Retorna a linha m da matriz, calculando-a se necessário.
+      *
+      * @param m O índice da amostra.
+      * @return Os produtos escalares entre a amostra m e cada amostra do conjunto.
+      */
+    std::span<const std::int64_t> row(std::size_t m) {
+        std::vector<std::int64_t> &values = rows[m];
+        if (values.empty()) {
+            values.resize(dataset.size());
+            const auto &data = dataset[m];
+            for (std::size_t n = 0; n < dataset.size(); ++n) {
+                // A matriz é simétrica: aproveita a linha n, se ela já foi calculada
+                values[n] = n != m && !rows[n].empty() ? rows[n][m] : gram_detail::dot(data, dataset[n], dimension);
+            }
+        }
+        return values;
+    }
+};
+
+#endif //SINGLELAYERPERCEPTRON_GRAM_MATRIX_H
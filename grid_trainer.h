@@ -0,0 +1,200 @@
+#ifndef SINGLELAYERPERCEPTRON_GRID_TRAINER_H
+#define SINGLELAYERPERCEPTRON_GRID_TRAINER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "binary_dataset.h"
+#include "bipolar.h"
+#include "epoch_order.h"
+#include "single_layer_perceptron.h"
+#include "sparse.h"
+#include "training.h"
+
+/**
+  * Um ponto da grade de hiperparâmetros.
+  */
+struct GridPoint {
+    double learning_rate;
+    double theta;
+};
+
+/**
+  * Treina vários modelos com a mesma forma e hiperparâmetros diferentes em uma única passagem pelos dados.
+  *
+  * Treinar cada ponto da grade com o seu próprio 'train' lê o conjunto de dados inteiro uma vez por ponto e por
+  * época. Aqui as épocas de todos os modelos andam juntas: cada bloco de amostras é lido uma vez e aplicado a
+  * todos os modelos ainda em treinamento enquanto está na cache. Cada modelo continua visitando as amostras na
+  * mesma ordem que 'train', então o resultado de cada um é idêntico ao de 'train' com os mesmos hiperparâmetros.
+  * Um modelo é retirado da passagem assim que atinge a sua condição de parada.
+  */
+class GridTrainer {
+private:
+    // Número aproximado de bytes de pontos de dados de cada bloco aplicado a todos os modelos
+    static constexpr std::size_t block_bytes = std::size_t{256} << 10;
+
+    const int dimension;
+    const int num_classes;
+    std::vector<SingleLayerPerceptron> models;
+
+    /**
+      * Executa as épocas de todos os modelos ativos juntas, com o mesmo acompanhamento de 'run_epochs' para cada
+      * modelo (veja 'EpochTracker').
+      *
+      * @param dataset Os dados de treinamento (veja 'SingleLayerPerceptron::internal_train').
+      * @param target A saída desejada para cada ponto de dados no dataset.
+      * @param options Os limites do treinamento, aplicados a cada modelo separadamente.
+      * @return O resultado de cada modelo.
+      */
+    template<typename Dataset, typename Target>
+    std::vector<TrainResult> internal_train(const Dataset &dataset, const Target &target, const TrainOptions &options) {
+        const std::size_t count = models.size();
+        const std::size_t samples = dataset.size();
+        const std::size_t sample_bytes = std::max<std::size_t>(1, static_cast<std::size_t>(dimension) * sizeof(int));
+        const std::size_t block = std::max<std::size_t>(1, block_bytes / sample_bytes);
+
+        // Estado de cada modelo, como em 'run_epochs' e 'internal_train_until'
+        std::vector<EpochTracker> trackers;
+        trackers.reserve(count);
+        std::vector<std::optional<SingleLayerPerceptron::Averaging>> averaging(count);
+        for (std::size_t k = 0; k < count; ++k) {
+            trackers.emplace_back(dataset, static_cast<std::size_t>(dimension), static_cast<std::size_t>(num_classes),
+                                  options);
+            if (options.average) {
+                averaging[k].emplace(SingleLayerPerceptron::Averaging{
+                        WeightMatrix(static_cast<std::size_t>(num_classes) * models[k].stride)});
+            }
+        }
+        // A ordem de cada época é a mesma para todos os modelos, então é sorteada uma única vez
+        std::optional<EpochOrder> order;
+        if (options.shuffle) {
+            order.emplace(samples, options.shuffle_seed, options.shuffle_block);
+        }
+
+        std::vector<std::size_t> active(count);
+        for (std::size_t k = 0; k < count; ++k) {
+            active[k] = k;
+        }
+
+        std::vector<EpochStats> stats(count);
+        for (std::size_t number = 1; !active.empty(); ++number) {
+            if (order) {
+                order->shuffle(number);
+            }
+            const std::span<const std::size_t> positions = order ? order->order() : std::span<const std::size_t>{};
+            for (const std::size_t k: active) {
+                stats[k] = EpochStats{};
+            }
+
+            // Cada bloco de amostras passa por todos os modelos ativos antes do próximo bloco
+            for (std::size_t first = 0; first < samples; first += block) {
+                const std::size_t last = std::min(samples, first + block);
+                for (const std::size_t k: active) {
+                    SingleLayerPerceptron &model = models[k];
+                    const EpochStats part = model.internal_train_range(
+                            dataset, target, first, last, model.weights.data(), trackers[k].cycle_detector(),
+                            positions, averaging[k] ? &*averaging[k] : nullptr);
+                    stats[k].misclassifications += part.misclassifications;
+                    stats[k].updates += part.updates;
+                    stats[k].evaluations += part.evaluations;
+                }
+            }
+
+            std::erase_if(active, [&](std::size_t k) {
+                if (!trackers[k].end_epoch(stats[k], number)) {
+                    return false;
+                }
+                // Retira o modelo da passagem
+                if (averaging[k]) {
+                    models[k].apply_average(*averaging[k]);
+                }
+                models[k].refresh_bitplanes();
+                return true;
+            });
+        }
+
+        std::vector<TrainResult> results;
+        results.reserve(count);
+        for (const EpochTracker &tracker: trackers) {
+            results.push_back(tracker.result());
+        }
+        return results;
+    }
+
+public:
+    /**
+      * Cria um modelo novo para cada ponto da grade.
+      *
+      * @param dimension A dimensão dos dados de entrada.
+      * @param num_classes O número de neurônios de cada modelo.
+      * @param points Os hiperparâmetros de cada modelo.
+      */
+    GridTrainer(int dimension, int num_classes, std::span<const GridPoint> points)
+            : dimension(dimension), num_classes(num_classes) {
+        models.reserve(points.size());
+        for (const GridPoint &point: points) {
+            models.emplace_back(dimension, num_classes, point.learning_rate, point.theta);
+        }
+    }
+
+    /**
+      * Monta a grade com todas as combinações de taxas de aprendizado e thetas, com theta variando mais rápido.
+      */
+    static std::vector<GridPoint> grid(std::span<const double> learning_rates, std::span<const double> thetas) {
+        std::vector<GridPoint> points;
+        points.reserve(learning_rates.size() * thetas.size());
+        for (const double learning_rate: learning_rates) {
+            for (const double theta: thetas) {
+                points.push_back({learning_rate, theta});
+            }
+        }
+        return points;
+    }
+
+    /**
+      * Treina todos os modelos com os mesmos dados e opções.
+      *
+      * @param dataset Os pontos de dados: um vetor 2D de números inteiros, um PackedBipolarDataset ou um
+      *                SparseDataset (veja 'SingleLayerPerceptron::train').
+      * @param target A saída desejada para cada ponto de dados no dataset: um vetor 2D ou uma MatrixView<int>.
+      * @param options Os limites do treinamento, aplicados a cada modelo separadamente (veja
+      *                'SingleLayerPerceptron::train'). 'on_epoch' é chamado ao fim de cada época de cada modelo ainda
+      *                ativo, na ordem dos modelos.
+      * @return O resultado de cada modelo, na ordem dos pontos da grade.
+      * @throws std::invalid_argument se a forma dos dados ou das saídas desejadas diferir da dos modelos.
+      */
+    template<TrainingData Data = std::vector<std::vector<int>>,
+             TrainingTarget Target = std::vector<std::vector<int>>>
+    std::vector<TrainResult> train(const Data &dataset, const Target &target, const TrainOptions &options = {}) {
+        check_training_shape(dataset, target, static_cast<std::size_t>(dimension),
+                             static_cast<std::size_t>(num_classes), "GridTrainer");
+        return internal_train(dataset, target, options);
+    }
+
+    /**
+      * Versão de 'train' para um conjunto que guarda as saídas desejadas: um Dataset ou um BinaryDataset, cujos
+      * blocos são usados diretamente.
+      */
+    template<LabeledData Data>
+    std::vector<TrainResult> train(const Data &dataset, const TrainOptions &options = {}) {
+        check_training_shape(dataset, static_cast<std::size_t>(dimension), static_cast<std::size_t>(num_classes),
+                             "GridTrainer");
+        return with_labels(dataset, [&](const auto &data, const auto &labels) {
+            return internal_train(data, labels, options);
+        });
+    }
+
+    [[nodiscard]] std::size_t size() const { return models.size(); }
+
+    /**
+      * @return O modelo treinado com o ponto k da grade.
+      */
+    [[nodiscard]] const SingleLayerPerceptron &model(std::size_t k) const { return models[k]; }
+
+    [[nodiscard]] SingleLayerPerceptron &model(std::size_t k) { return models[k]; }
+};
+
+#endif //SINGLELAYERPERCEPTRON_GRID_TRAINER_H
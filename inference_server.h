@@ -0,0 +1,493 @@
+#ifndef SINGLELAYERPERCEPTRON_INFERENCE_SERVER_H
+#define SINGLELAYERPERCEPTRON_INFERENCE_SERVER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "model_handle.h"
+#include "single_layer_perceptron.h"
+
+/**
+  * Protocolo binário do servidor de inferência (veja 'InferenceServer'). Cada mensagem é um cabeçalho de 16 bytes
+  * seguido de uma matriz de inteiros de 32 bits, linha a linha; os valores usam a ordem de bytes da máquina, já que
+  * cliente e servidor estão sempre na mesma máquina. Uma conexão pode enviar vários pedidos, um de cada vez.
+  *
+  * Pedido: 'count' pontos de dados com 'dimension' valores cada.
+  * Resposta: 'status' e, se for 'ok', as saídas da função de ativação dos 'classes' neurônios para cada ponto.
+  */
+struct InferenceRequestHeader {
+    static constexpr char expected_magic[4] = {'S', 'L', 'P', 'Q'};
+
+    char magic[4];
+    std::uint32_t count;
+    std::uint32_t dimension;
+    std::uint32_t reserved;
+};
+
+struct InferenceResponseHeader {
+    static constexpr char expected_magic[4] = {'S', 'L', 'P', 'R'};
+
+    char magic[4];
+    std::uint32_t status;
+    std::uint32_t count;
+    std::uint32_t classes;
+};
+
+static_assert(sizeof(InferenceRequestHeader) == 16, "o cabecalho do pedido deve ter 16 bytes");
+static_assert(sizeof(InferenceResponseHeader) == 16, "o cabecalho da resposta deve ter 16 bytes");
+
+enum class InferenceStatus : std::uint32_t {
+    ok = 0,
+    // A dimensão do pedido difere da do modelo; a conexão continua aberta
+    wrong_dimension = 1,
+    // O pedido tem mais de 'InferenceServerOptions::max_request' pontos de dados (ou valores demais para
+    // esse número de pontos); a conexão é fechada
+    too_large = 2
+};
+
+namespace inference_detail {
+
+/**
+  * Lê exatamente 'size' bytes de um socket.
+  *
+  * @return Falso se a conexão foi fechada ou ocorreu um erro antes de ler todos os bytes.
+  */
+inline bool read_all(int fd, void *buffer, std::size_t size) {
+    auto *bytes = static_cast<char *>(buffer);
+    while (size > 0) {
+        const ssize_t count = ::read(fd, bytes, size);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        bytes += count;
+        size -= static_cast<std::size_t>(count);
+    }
+    return true;
+}
+
+/**
+  * Escreve exatamente 'size' bytes em um socket, sem gerar SIGPIPE se o outro lado já fechou a conexão.
+  *
+  * @return Falso se ocorreu um erro antes de escrever todos os bytes.
+  */
+inline bool write_all(int fd, const void *buffer, std::size_t size) {
+#ifdef MSG_NOSIGNAL
+    constexpr int flags = MSG_NOSIGNAL;
+#else
+    constexpr int flags = 0;
+#endif
+    const auto *bytes = static_cast<const char *>(buffer);
+    while (size > 0) {
+        const ssize_t count = ::send(fd, bytes, size, flags);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        bytes += count;
+        size -= static_cast<std::size_t>(count);
+    }
+    return true;
+}
+
+/**
+  * Monta o endereço de um socket UNIX.
+  *
+  * @throws std::runtime_error se o caminho não couber no endereço.
+  */
+inline sockaddr_un socket_address(const std::string &path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("InferenceServer: caminho de socket invalido: " + path);
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return address;
+}
+
+} // namespace inference_detail
+
+/**
+  * Parâmetros do agrupamento de pedidos do servidor de inferência.
+  */
+struct InferenceServerOptions {
+    // Número máximo de pontos de dados de um lote; um pedido maior que o lote é processado sozinho
+    std::size_t max_batch = 256;
+    // Tempo máximo que o primeiro pedido de um lote espera por outros pedidos
+    std::chrono::microseconds max_wait{200};
+    // Número máximo de pontos de dados de um único pedido
+    std::size_t max_request = std::size_t{1} << 16;
+};
+
+/**
+  * Servidor de inferência local: atende pedidos de predição de um modelo por um socket UNIX, com o protocolo de
+  * 'InferenceRequestHeader'.
+  *
+  * Cada conexão é atendida por uma thread, que coloca os seus pedidos em uma fila comum e espera a resposta. Uma
+  * única thread de predição agrupa os pedidos da fila em lotes de até 'max_batch' pontos de dados, esperando no
+  * máximo 'max_wait' por outros pedidos depois do primeiro, e calcula cada lote com uma chamada de
+  * 'predict_batch'. Assim o custo fixo de cada chamada é dividido entre muitos clientes pequenos.
+  */
+class InferenceServer {
+private:
+    // Um pedido na fila, com os buffers da thread da conexão
+    struct Pending {
+        std::span<const int> data;
+        std::span<int> output;
+        std::size_t count = 0;
+        bool done = false;
+    };
+
+    // Uma conexão aberta
+    struct Connection {
+        int fd = -1;
+        std::atomic<bool> finished{false};
+        std::jthread thread;
+    };
+
+    // O modelo fixo ou, com um ModelHandle, nulo
+    const SingleLayerPerceptron *model;
+    ModelHandle *handle;
+    const std::size_t dimension;
+    const std::size_t classes;
+    const InferenceServerOptions options;
+    const std::string path;
+    int listen_fd = -1;
+
+    std::mutex mutex;
+    // Avisa a thread de predição que há pedidos na fila ou que o servidor está parando
+    std::condition_variable queued;
+    // Avisa as threads das conexões que um lote foi calculado
+    std::condition_variable scored;
+    std::deque<Pending *> queue;
+    std::size_t queued_samples = 0;
+    bool stopping = false;
+
+    /**
+      * Coloca um pedido na fila e espera o resultado.
+      *
+      * @return Falso se o servidor está parando e o pedido não foi aceito.
+      */
+    bool submit(Pending &pending) {
+        std::unique_lock lock(mutex);
+        if (stopping) {
+            return false;
+        }
+        queue.push_back(&pending);
+        queued_samples += pending.count;
+        queued.notify_one();
+        scored.wait(lock, [&] { return pending.done; });
+        return true;
+    }
+
+    /**
+      * Laço da thread de predição: forma lotes com os pedidos da fila e os calcula até que o servidor pare e a fila
+      * esvazie.
+      */
+    void score_batches() {
+        std::vector<Pending *> batch;
+        std::vector<int> input;
+        std::vector<int> output;
+        std::optional<ModelHandle::Reader> reader;
+        if (handle != nullptr) {
+            reader.emplace(*handle);
+        }
+        std::unique_lock lock(mutex);
+        while (true) {
+            queued.wait(lock, [&] { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                return;
+            }
+
+            // Espera outros pedidos até completar o lote ou até o prazo do primeiro pedido
+            const auto deadline = std::chrono::steady_clock::now() + options.max_wait;
+            queued.wait_until(lock, deadline, [&] { return stopping || queued_samples >= options.max_batch; });
+
+            std::size_t total = 0;
+            batch.clear();
+            while (!queue.empty() && (batch.empty() || total + queue.front()->count <= options.max_batch)) {
+                total += queue.front()->count;
+                batch.push_back(queue.front());
+                queue.pop_front();
+            }
+            queued_samples -= total;
+            lock.unlock();
+
+            // Junta os pedidos em uma única matriz e calcula o lote de uma vez
+            input.resize(total * dimension);
+            output.resize(total * classes);
+            std::size_t offset = 0;
+            for (const Pending *pending: batch) {
+                std::copy(pending->data.begin(), pending->data.end(), input.begin() + offset * dimension);
+                offset += pending->count;
+            }
+            if (reader) {
+                // Cada lote usa a versão publicada no seu início
+                reader->read()->predict_batch(input, output);
+            } else {
+                model->predict_batch(input, output);
+            }
+            offset = 0;
+            for (Pending *pending: batch) {
+                std::copy_n(output.begin() + offset * classes, pending->output.size(), pending->output.begin());
+                offset += pending->count;
+            }
+
+            lock.lock();
+            for (Pending *pending: batch) {
+                pending->done = true;
+            }
+            scored.notify_all();
+        }
+    }
+
+    bool respond(int fd, InferenceStatus status, std::uint32_t count, std::span<const int> output) const {
+        InferenceResponseHeader header{};
+        std::memcpy(header.magic, InferenceResponseHeader::expected_magic, sizeof(header.magic));
+        header.status = static_cast<std::uint32_t>(status);
+        header.count = count;
+        header.classes = static_cast<std::uint32_t>(classes);
+        return inference_detail::write_all(fd, &header, sizeof(header)) &&
+               inference_detail::write_all(fd, output.data(), output.size_bytes());
+    }
+
+    /**
+      * Atende os pedidos de uma conexão até que ela seja fechada.
+      */
+    void serve(int fd) {
+        std::vector<int> data;
+        std::vector<int> output;
+        InferenceRequestHeader header{};
+        while (inference_detail::read_all(fd, &header, sizeof(header))) {
+            if (std::memcmp(header.magic, InferenceRequestHeader::expected_magic, sizeof(header.magic)) != 0) {
+                return;
+            }
+            if (header.count > options.max_request ||
+                std::size_t{header.count} * header.dimension > options.max_request * dimension) {
+                respond(fd, InferenceStatus::too_large, 0, {});
+                return;
+            }
+
+            data.resize(std::size_t{header.count} * header.dimension);
+            if (!inference_detail::read_all(fd, data.data(), data.size() * sizeof(int))) {
+                return;
+            }
+            if (header.dimension != dimension) {
+                if (!respond(fd, InferenceStatus::wrong_dimension, 0, {})) {
+                    return;
+                }
+                continue;
+            }
+
+            output.resize(std::size_t{header.count} * classes);
+            Pending pending{data, output, header.count};
+            if (!submit(pending) || !respond(fd, InferenceStatus::ok, header.count, output)) {
+                return;
+            }
+        }
+    }
+
+    InferenceServer(const SingleLayerPerceptron *model, ModelHandle *handle, int dimension, int classes,
+                    const std::string &path, InferenceServerOptions options)
+            : model(model), handle(handle), dimension(static_cast<std::size_t>(dimension)),
+              classes(static_cast<std::size_t>(classes)), options(options), path(path) {
+        const sockaddr_un address = inference_detail::socket_address(path);
+        struct stat status{};
+        if (::lstat(path.c_str(), &status) == 0 && S_ISSOCK(status.st_mode)) {
+            ::unlink(path.c_str());
+        }
+
+        listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listen_fd < 0) {
+            throw std::runtime_error("InferenceServer: nao foi possivel criar o socket");
+        }
+        if (::bind(listen_fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0 ||
+            ::listen(listen_fd, SOMAXCONN) != 0) {
+            ::close(listen_fd);
+            throw std::runtime_error("InferenceServer: nao foi possivel escutar em " + path + ": " +
+                                     std::strerror(errno));
+        }
+    }
+
+public:
+    /**
+      * Cria o socket e começa a aceitar conexões; os pedidos só são atendidos depois de 'run'.
+      * Um socket antigo no mesmo caminho é removido.
+      *
+      * @param model O modelo; deve continuar válido e não pode ser treinado enquanto o servidor existir.
+      * @param path O caminho do socket UNIX.
+      * @param options Os parâmetros do agrupamento de pedidos.
+      * @throws std::runtime_error se o socket não puder ser criado.
+      */
+    InferenceServer(const SingleLayerPerceptron &model, const std::string &path, InferenceServerOptions options = {})
+            : InferenceServer(&model, nullptr, model.input_dimension(), model.class_count(), path, options) {}
+
+    /**
+      * Versão do construtor que serve a versão atual de um ModelHandle: novas versões publicadas enquanto o
+      * servidor roda passam a ser usadas a partir do próximo lote, sem pausar os pedidos. Usa um slot de leitura
+      * do handle durante 'run'.
+      *
+      * @param handle O modelo; deve continuar válido enquanto o servidor existir.
+      */
+    InferenceServer(ModelHandle &handle, const std::string &path, InferenceServerOptions options = {})
+            : InferenceServer(nullptr, &handle, handle.input_dimension(), handle.class_count(), path, options) {}
+
+    InferenceServer(const InferenceServer &) = delete;
+
+    InferenceServer &operator=(const InferenceServer &) = delete;
+
+    ~InferenceServer() {
+        ::close(listen_fd);
+        ::unlink(path.c_str());
+    }
+
+    /**
+      * Atende conexões até que 'stop' seja verdadeiro. Ao parar, os pedidos já na fila são respondidos e todas as
+      * conexões são fechadas.
+      *
+      * @param stop Verificado a cada 'poll_interval' e a cada nova conexão; pode ser alterado por um tratador de sinal.
+      * @param poll_interval O intervalo entre as verificações de 'stop'.
+      */
+    void run(const std::atomic<bool> &stop,
+             std::chrono::milliseconds poll_interval = std::chrono::milliseconds(100)) {
+        std::list<Connection> connections;
+        std::jthread scorer([this] { score_batches(); });
+
+        while (!stop.load()) {
+            pollfd listener{listen_fd, POLLIN, 0};
+            const int ready = ::poll(&listener, 1, static_cast<int>(poll_interval.count()));
+            if (ready <= 0) {
+                continue;
+            }
+            const int fd = ::accept(listen_fd, nullptr, nullptr);
+            if (fd < 0) {
+                continue;
+            }
+
+            // Fecha as conexões que já terminaram
+            for (auto it = connections.begin(); it != connections.end();) {
+                if (it->finished.load()) {
+                    it->thread.join();
+                    ::close(it->fd);
+                    it = connections.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            Connection &connection = connections.emplace_back();
+            connection.fd = fd;
+            connection.thread = std::jthread([this, &connection] {
+                serve(connection.fd);
+                connection.finished = true;
+            });
+        }
+
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+            queued.notify_one();
+        }
+        // Interrompe as leituras pendentes; os descritores só são fechados depois que as threads terminam
+        for (Connection &connection: connections) {
+            ::shutdown(connection.fd, SHUT_RDWR);
+        }
+        for (Connection &connection: connections) {
+            connection.thread.join();
+            ::close(connection.fd);
+        }
+    }
+};
+
+/**
+  * Cliente do servidor de inferência, com uma conexão aberta enquanto o objeto existir.
+  */
+class InferenceClient {
+private:
+    int fd = -1;
+    std::uint32_t dimension;
+
+public:
+    /**
+      * @param path O caminho do socket do servidor.
+      * @param dimension A dimensão dos pontos de dados do modelo.
+      * @throws std::runtime_error se não for possível conectar ao servidor.
+      */
+    InferenceClient(const std::string &path, std::uint32_t dimension) : dimension(dimension) {
+        const sockaddr_un address = inference_detail::socket_address(path);
+        fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0 || ::connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            throw std::runtime_error("InferenceClient: nao foi possivel conectar a " + path);
+        }
+    }
+
+    InferenceClient(const InferenceClient &) = delete;
+
+    InferenceClient &operator=(const InferenceClient &) = delete;
+
+    ~InferenceClient() { ::close(fd); }
+
+    /**
+      * Pede a predição de um ou mais pontos de dados.
+      *
+      * @param data Matriz N x dimension, linha a linha, com os pontos de dados.
+      * @return Matriz N x num_classes, linha a linha, com as saídas da função de ativação.
+      * @throws std::runtime_error se o servidor recusar o pedido ou a conexão for perdida.
+      */
+    std::vector<int> predict(std::span<const int> data) {
+        if (dimension == 0 || data.size() % dimension != 0) {
+            throw std::invalid_argument("InferenceClient: o tamanho da entrada nao e multiplo da dimensao");
+        }
+        InferenceRequestHeader request{};
+        std::memcpy(request.magic, InferenceRequestHeader::expected_magic, sizeof(request.magic));
+        request.count = static_cast<std::uint32_t>(data.size() / dimension);
+        request.dimension = dimension;
+
+        InferenceResponseHeader response{};
+        if (!inference_detail::write_all(fd, &request, sizeof(request)) ||
+            !inference_detail::write_all(fd, data.data(), data.size_bytes()) ||
+            !inference_detail::read_all(fd, &response, sizeof(response)) ||
+            std::memcmp(response.magic, InferenceResponseHeader::expected_magic, sizeof(response.magic)) != 0) {
+            throw std::runtime_error("InferenceClient: conexao perdida");
+        }
+        if (response.status != static_cast<std::uint32_t>(InferenceStatus::ok)) {
+            throw std::runtime_error("InferenceClient: pedido recusado pelo servidor (status " +
+                                     std::to_string(response.status) + ")");
+        }
+
+        std::vector<int> output(std::size_t{response.count} * response.classes);
+        if (!inference_detail::read_all(fd, output.data(), output.size() * sizeof(int))) {
+            throw std::runtime_error("InferenceClient: conexao perdida");
+        }
+        return output;
+    }
+};
+
+#endif //SINGLELAYERPERCEPTRON_INFERENCE_SERVER_H
@@ -0,0 +1,491 @@
+#ifndef SINGLELAYERPERCEPTRON_KERNELS_H
+#define SINGLELAYERPERCEPTRON_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+// Os kernels nunca fundem multiplicações e somas em FMA, que mudaria o arredondamento em relação às outras versões.
+// O clang não tem um atributo de função para isso: o código entre SLP_FP_CONTRACT_OFF_BEGIN e
+// SLP_FP_CONTRACT_OFF_END (em escopo de arquivo ou de namespace) é compilado sem FMA, e o estado anterior é
+// restaurado ao final, então o código de quem inclui este arquivo não é afetado.
+#if defined(__clang__)
+#define SLP_NO_FMA
+#define SLP_FP_CONTRACT_OFF_BEGIN _Pragma("float_control(push)") _Pragma("clang fp contract(off)")
+#define SLP_FP_CONTRACT_OFF_END _Pragma("float_control(pop)")
+#elif defined(__GNUC__)
+#define SLP_NO_FMA __attribute__((optimize("fp-contract=off")))
+#define SLP_FP_CONTRACT_OFF_BEGIN
+#define SLP_FP_CONTRACT_OFF_END
+#else
+#define SLP_NO_FMA
+#define SLP_FP_CONTRACT_OFF_BEGIN
+#define SLP_FP_CONTRACT_OFF_END
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SLP_KERNELS_X86 1
+#include <immintrin.h>
+#define SLP_TARGET(isa) __attribute__((target(isa))) SLP_NO_FMA
+#endif
+
+/**
+  * Kernels do produto escalar (usado por act_func) e da atualização de posto 1 (usada por ch_weights)
+  * entre dados inteiros e pesos decimais.
+  *
+  * Todas as versões acumulam o produto escalar em 'lanes' somas parciais independentes: o elemento j é somado
+  * à parcial j % lanes, sempre multiplicando e somando separadamente (sem FMA). As parciais são combinadas por
+  * 'reduce' sempre na mesma ordem, de modo que a versão escalar e as versões SSE4.2, AVX2 e AVX-512 produzem
+  * resultados idênticos bit a bit. A versão usada é escolhida uma única vez, na primeira chamada de 'active',
+  * a partir das instruções suportadas pelo processador (CPUID).
+  */
+SLP_FP_CONTRACT_OFF_BEGIN
+namespace kernels {
+
+// Número de somas parciais usadas pelo produto escalar
+inline constexpr std::size_t lanes = 8;
+
+// Número de amostras processadas juntas por 'dot4'
+inline constexpr std::size_t dot4_rows = 4;
+
+enum class Isa {
+    scalar,
+    sse42,
+    avx2,
+    avx512
+};
+
+struct KernelTable {
+    // Nome do conjunto de instruções usado pelos kernels
+    const char *name;
+
+    // Soma x[j] * w[j] à parcial acc[j % lanes], para j em [0, n)
+    void (*dot)(const int *x, const double *w, std::size_t n, double *acc);
+
+    // Igual a 'dot' para 4 amostras espaçadas de x_stride; as parciais da amostra s ficam em acc[s * lanes]
+    void (*dot4)(const int *x, std::size_t x_stride, const double *w, std::size_t n, double *acc);
+
+    // Faz w[j] = w[j] + scale * x[j], para j em [0, n)
+    void (*axpy)(const int *x, double scale, double *w, std::size_t n);
+
+    // Igual a 'dot' para uma entrada bipolar empacotada: x[j] é +1 se o bit j de 'bits' estiver ligado e -1 caso contrário
+    void (*dot_bipolar)(const std::uint64_t *bits, const double *w, std::size_t n, double *acc);
+
+    // Igual a 'axpy' para uma entrada bipolar empacotada
+    void (*axpy_bipolar)(const std::uint64_t *bits, double scale, double *w, std::size_t n);
+};
+
+/**
+  * Valor bipolar (+1 ou -1) do elemento j de uma entrada empacotada.
+  */
+inline bool bipolar_bit(const std::uint64_t *bits, std::size_t j) {
+    return (bits[j / 64] >> (j % 64)) & 1u;
+}
+
+/**
+  * Combina as somas parciais do produto escalar sempre na mesma ordem.
+  *
+  * @param acc As 'lanes' somas parciais.
+  * @return A soma de todas as parciais.
+  */
+inline double reduce(const double *acc) {
+    const double s0 = acc[0] + acc[4];
+    const double s1 = acc[1] + acc[5];
+    const double s2 = acc[2] + acc[6];
+    const double s3 = acc[3] + acc[7];
+    return (s0 + s2) + (s1 + s3);
+}
+
+namespace scalar {
+
+SLP_NO_FMA inline void dot(const int *x, const double *w, std::size_t n, double *acc) {
+    for (std::size_t j = 0; j < n; ++j) {
+        acc[j % lanes] += x[j] * w[j];
+    }
+}
+
+SLP_NO_FMA inline void dot4(const int *x, std::size_t x_stride, const double *w, std::size_t n, double *acc) {
+    for (std::size_t s = 0; s < dot4_rows; ++s) {
+        dot(x + s * x_stride, w, n, acc + s * lanes);
+    }
+}
+
+SLP_NO_FMA inline void axpy(const int *x, double scale, double *w, std::size_t n) {
+    for (std::size_t j = 0; j < n; ++j) {
+        w[j] = w[j] + scale * x[j];
+    }
+}
+
+// Como x[j] é +1 ou -1, x[j] * w[j] é exatamente w[j] ou -w[j]: as versões bipolares somam o mesmo valor que
+// as versões densas e produzem resultados idênticos bit a bit.
+
+SLP_NO_FMA inline void dot_bipolar(const std::uint64_t *bits, const double *w, std::size_t n, double *acc) {
+    for (std::size_t j = 0; j < n; ++j) {
+        acc[j % lanes] += bipolar_bit(bits, j) ? w[j] : -w[j];
+    }
+}
+
+SLP_NO_FMA inline void axpy_bipolar(const std::uint64_t *bits, double scale, double *w, std::size_t n) {
+    for (std::size_t j = 0; j < n; ++j) {
+        w[j] = w[j] + (bipolar_bit(bits, j) ? scale : -scale);
+    }
+}
+
+} // namespace scalar
+
+#ifdef SLP_KERNELS_X86
+
+namespace sse42 {
+
+SLP_TARGET("sse4.2") inline void dot(const int *x, const double *w, std::size_t n, double *acc) {
+    __m128d a0 = _mm_loadu_pd(acc);
+    __m128d a1 = _mm_loadu_pd(acc + 2);
+    __m128d a2 = _mm_loadu_pd(acc + 4);
+    __m128d a3 = _mm_loadu_pd(acc + 6);
+    std::size_t j = 0;
+    for (; j + lanes <= n; j += lanes) {
+        a0 = _mm_add_pd(a0, _mm_mul_pd(_mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(x + j))),
+                                       _mm_loadu_pd(w + j)));
+        a1 = _mm_add_pd(a1, _mm_mul_pd(_mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(x + j + 2))),
+                                       _mm_loadu_pd(w + j + 2)));
+        a2 = _mm_add_pd(a2, _mm_mul_pd(_mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(x + j + 4))),
+                                       _mm_loadu_pd(w + j + 4)));
+        a3 = _mm_add_pd(a3, _mm_mul_pd(_mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(x + j + 6))),
+                                       _mm_loadu_pd(w + j + 6)));
+    }
+    _mm_storeu_pd(acc, a0);
+    _mm_storeu_pd(acc + 2, a1);
+    _mm_storeu_pd(acc + 4, a2);
+    _mm_storeu_pd(acc + 6, a3);
+    for (; j < n; ++j) {
+        acc[j % lanes] += x[j] * w[j];
+    }
+}
+
+SLP_TARGET("sse4.2") inline void dot4(const int *x, std::size_t x_stride, const double *w, std::size_t n,
+                                      double *acc) {
+    for (std::size_t s = 0; s < dot4_rows; ++s) {
+        dot(x + s * x_stride, w, n, acc + s * lanes);
+    }
+}
+
+SLP_TARGET("sse4.2") inline void axpy(const int *x, double scale, double *w, std::size_t n) {
+    const __m128d k = _mm_set1_pd(scale);
+    std::size_t j = 0;
+    for (; j + 2 <= n; j += 2) {
+        const __m128d xv = _mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(x + j)));
+        _mm_storeu_pd(w + j, _mm_add_pd(_mm_loadu_pd(w + j), _mm_mul_pd(k, xv)));
+    }
+    for (; j < n; ++j) {
+        w[j] = w[j] + scale * x[j];
+    }
+}
+
+} // namespace sse42
+
+namespace avx2 {
+
+SLP_TARGET("avx2") inline __m256d load_x(const int *x) {
+    return _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i *>(x)));
+}
+
+SLP_TARGET("avx2") inline void dot(const int *x, const double *w, std::size_t n, double *acc) {
+    __m256d lo = _mm256_loadu_pd(acc);
+    __m256d hi = _mm256_loadu_pd(acc + 4);
+    std::size_t j = 0;
+    for (; j + lanes <= n; j += lanes) {
+        lo = _mm256_add_pd(lo, _mm256_mul_pd(load_x(x + j), _mm256_loadu_pd(w + j)));
+        hi = _mm256_add_pd(hi, _mm256_mul_pd(load_x(x + j + 4), _mm256_loadu_pd(w + j + 4)));
+    }
+    _mm256_storeu_pd(acc, lo);
+    _mm256_storeu_pd(acc + 4, hi);
+    for (; j < n; ++j) {
+        acc[j % lanes] += x[j] * w[j];
+    }
+}
+
+SLP_TARGET("avx2") inline void dot4(const int *x, std::size_t x_stride, const double *w, std::size_t n,
+                                    double *acc) {
+    const int *x0 = x;
+    const int *x1 = x0 + x_stride;
+    const int *x2 = x1 + x_stride;
+    const int *x3 = x2 + x_stride;
+    __m256d lo0 = _mm256_loadu_pd(acc), hi0 = _mm256_loadu_pd(acc + 4);
+    __m256d lo1 = _mm256_loadu_pd(acc + 8), hi1 = _mm256_loadu_pd(acc + 12);
+    __m256d lo2 = _mm256_loadu_pd(acc + 16), hi2 = _mm256_loadu_pd(acc + 20);
+    __m256d lo3 = _mm256_loadu_pd(acc + 24), hi3 = _mm256_loadu_pd(acc + 28);
+    std::size_t j = 0;
+    for (; j + lanes <= n; j += lanes) {
+        // Cada bloco de pesos é carregado uma vez e usado pelas 4 amostras
+        const __m256d wl = _mm256_loadu_pd(w + j);
+        const __m256d wh = _mm256_loadu_pd(w + j + 4);
+        lo0 = _mm256_add_pd(lo0, _mm256_mul_pd(load_x(x0 + j), wl));
+        hi0 = _mm256_add_pd(hi0, _mm256_mul_pd(load_x(x0 + j + 4), wh));
+        lo1 = _mm256_add_pd(lo1, _mm256_mul_pd(load_x(x1 + j), wl));
+        hi1 = _mm256_add_pd(hi1, _mm256_mul_pd(load_x(x1 + j + 4), wh));
+        lo2 = _mm256_add_pd(lo2, _mm256_mul_pd(load_x(x2 + j), wl));
+        hi2 = _mm256_add_pd(hi2, _mm256_mul_pd(load_x(x2 + j + 4), wh));
+        lo3 = _mm256_add_pd(lo3, _mm256_mul_pd(load_x(x3 + j), wl));
+        hi3 = _mm256_add_pd(hi3, _mm256_mul_pd(load_x(x3 + j + 4), wh));
+    }
+    _mm256_storeu_pd(acc, lo0), _mm256_storeu_pd(acc + 4, hi0);
+    _mm256_storeu_pd(acc + 8, lo1), _mm256_storeu_pd(acc + 12, hi1);
+    _mm256_storeu_pd(acc + 16, lo2), _mm256_storeu_pd(acc + 20, hi2);
+    _mm256_storeu_pd(acc + 24, lo3), _mm256_storeu_pd(acc + 28, hi3);
+    for (; j < n; ++j) {
+        acc[j % lanes] += x0[j] * w[j];
+        acc[lanes + j % lanes] += x1[j] * w[j];
+        acc[2 * lanes + j % lanes] += x2[j] * w[j];
+        acc[3 * lanes + j % lanes] += x3[j] * w[j];
+    }
+}
+
+SLP_TARGET("avx2") inline void axpy(const int *x, double scale, double *w, std::size_t n) {
+    const __m256d k = _mm256_set1_pd(scale);
+    std::size_t j = 0;
+    for (; j + 4 <= n; j += 4) {
+        _mm256_storeu_pd(w + j, _mm256_add_pd(_mm256_loadu_pd(w + j), _mm256_mul_pd(k, load_x(x + j))));
+    }
+    for (; j < n; ++j) {
+        w[j] = w[j] + scale * x[j];
+    }
+}
+
+// Máscara com o bit de sinal ligado nos elementos cujo bit bipolar está desligado (x[j] = -1)
+SLP_TARGET("avx2") inline __m256d bipolar_sign(const std::uint64_t *bits, std::size_t j) {
+    const auto nibble = static_cast<long long>((bits[j / 64] >> (j % 64)) & 0xFu);
+    const __m256i select = _mm256_set_epi64x(8, 4, 2, 1);
+    const __m256i set = _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_set1_epi64x(nibble), select), select);
+    return _mm256_andnot_pd(_mm256_castsi256_pd(set), _mm256_set1_pd(-0.0));
+}
+
+SLP_TARGET("avx2") inline void dot_bipolar(const std::uint64_t *bits, const double *w, std::size_t n, double *acc) {
+    __m256d lo = _mm256_loadu_pd(acc);
+    __m256d hi = _mm256_loadu_pd(acc + 4);
+    std::size_t j = 0;
+    for (; j + lanes <= n; j += lanes) {
+        lo = _mm256_add_pd(lo, _mm256_xor_pd(_mm256_loadu_pd(w + j), bipolar_sign(bits, j)));
+        hi = _mm256_add_pd(hi, _mm256_xor_pd(_mm256_loadu_pd(w + j + 4), bipolar_sign(bits, j + 4)));
+    }
+    _mm256_storeu_pd(acc, lo);
+    _mm256_storeu_pd(acc + 4, hi);
+    for (; j < n; ++j) {
+        acc[j % lanes] += bipolar_bit(bits, j) ? w[j] : -w[j];
+    }
+}
+
+SLP_TARGET("avx2") inline void axpy_bipolar(const std::uint64_t *bits, double scale, double *w, std::size_t n) {
+    const __m256d k = _mm256_set1_pd(scale);
+    std::size_t j = 0;
+    for (; j + 4 <= n; j += 4) {
+        _mm256_storeu_pd(w + j, _mm256_add_pd(_mm256_loadu_pd(w + j), _mm256_xor_pd(k, bipolar_sign(bits, j))));
+    }
+    for (; j < n; ++j) {
+        w[j] = w[j] + (bipolar_bit(bits, j) ? scale : -scale);
+    }
+}
+
+} // namespace avx2
+
+namespace avx512 {
+
+SLP_TARGET("avx512f") inline __m512d load_x(const int *x) {
+    // A versão com máscara zera as posições não escritas em vez de usar _mm512_undefined_pd, que o GCC 12 acusa
+    // como -Wmaybe-uninitialized; com a máscara cheia a instrução gerada é a mesma
+    const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(x));
+    return _mm512_maskz_cvtepi32_pd(0xFF, values);
+}
+
+SLP_TARGET("avx512f") inline void dot(const int *x, const double *w, std::size_t n, double *acc) {
+    __m512d a = _mm512_loadu_pd(acc);
+    std::size_t j = 0;
+    for (; j + lanes <= n; j += lanes) {
+        a = _mm512_add_pd(a, _mm512_mul_pd(load_x(x + j), _mm512_loadu_pd(w + j)));
+    }
+    _mm512_storeu_pd(acc, a);
+    for (; j < n; ++j) {
+        acc[j % lanes] += x[j] * w[j];
+    }
+}
+
+SLP_TARGET("avx512f") inline void dot4(const int *x, std::size_t x_stride, const double *w, std::size_t n,
+                                       double *acc) {
+    const int *x0 = x;
+    const int *x1 = x0 + x_stride;
+    const int *x2 = x1 + x_stride;
+    const int *x3 = x2 + x_stride;
+    __m512d a0 = _mm512_loadu_pd(acc);
+    __m512d a1 = _mm512_loadu_pd(acc + 8);
+    __m512d a2 = _mm512_loadu_pd(acc + 16);
+    __m512d a3 = _mm512_loadu_pd(acc + 24);
+    std::size_t j = 0;
+    for (; j + lanes <= n; j += lanes) {
+        // Cada bloco de pesos é carregado uma vez e usado pelas 4 amostras
+        const __m512d wv = _mm512_loadu_pd(w + j);
+        a0 = _mm512_add_pd(a0, _mm512_mul_pd(load_x(x0 + j), wv));
+        a1 = _mm512_add_pd(a1, _mm512_mul_pd(load_x(x1 + j), wv));
+        a2 = _mm512_add_pd(a2, _mm512_mul_pd(load_x(x2 + j), wv));
+        a3 = _mm512_add_pd(a3, _mm512_mul_pd(load_x(x3 + j), wv));
+    }
+    _mm512_storeu_pd(acc, a0);
+    _mm512_storeu_pd(acc + 8, a1);
+    _mm512_storeu_pd(acc + 16, a2);
+    _mm512_storeu_pd(acc + 24, a3);
+    for (; j < n; ++j) {
+        acc[j % lanes] += x0[j] * w[j];
+        acc[lanes + j % lanes] += x1[j] * w[j];
+        acc[2 * lanes + j % lanes] += x2[j] * w[j];
+        acc[3 * lanes + j % lanes] += x3[j] * w[j];
+    }
+}
+
+SLP_TARGET("avx512f") inline void axpy(const int *x, double scale, double *w, std::size_t n) {
+    const __m512d k = _mm512_set1_pd(scale);
+    std::size_t j = 0;
+    for (; j + lanes <= n; j += lanes) {
+        _mm512_storeu_pd(w + j, _mm512_add_pd(_mm512_loadu_pd(w + j), _mm512_mul_pd(k, load_x(x + j))));
+    }
+    for (; j < n; ++j) {
+        w[j] = w[j] + scale * x[j];
+    }
+}
+
+// Seleciona w[j] onde o bit bipolar está ligado e -w[j] onde está desligado
+SLP_TARGET("avx512f") inline __m512d bipolar_select(const std::uint64_t *bits, std::size_t j, __m512d w) {
+    const auto mask = static_cast<__mmask8>((bits[j / 64] >> (j % 64)) & 0xFFu);
+    const __m512d negated = _mm512_castsi512_pd(
+            _mm512_xor_si512(_mm512_castpd_si512(w), _mm512_set1_epi64(static_cast<long long>(0x8000000000000000ull))));
+    return _mm512_mask_blend_pd(mask, negated, w);
+}
+
+SLP_TARGET("avx512f") inline void dot_bipolar(const std::uint64_t *bits, const double *w, std::size_t n,
+                                              double *acc) {
+    __m512d a = _mm512_loadu_pd(acc);
+    std::size_t j = 0;
+    for (; j + lanes <= n; j += lanes) {
+        a = _mm512_add_pd(a, bipolar_select(bits, j, _mm512_loadu_pd(w + j)));
+    }
+    _mm512_storeu_pd(acc, a);
+    for (; j < n; ++j) {
+        acc[j % lanes] += bipolar_bit(bits, j) ? w[j] : -w[j];
+    }
+}
+
+SLP_TARGET("avx512f") inline void axpy_bipolar(const std::uint64_t *bits, double scale, double *w,
+                                               std::size_t n) {
+    const __m512d k = _mm512_set1_pd(scale);
+    std::size_t j = 0;
+    for (; j + lanes <= n; j += lanes) {
+        _mm512_storeu_pd(w + j, _mm512_add_pd(_mm512_loadu_pd(w + j), bipolar_select(bits, j, k)));
+    }
+    for (; j < n; ++j) {
+        w[j] = w[j] + (bipolar_bit(bits, j) ? scale : -scale);
+    }
+}
+
+} // namespace avx512
+
+#endif // SLP_KERNELS_X86
+
+/**
+  * Verifica se o processador suporta o conjunto de instruções.
+  *
+  * @param isa O conjunto de instruções.
+  * @return Verdadeiro se os kernels desse conjunto podem ser executados.
+  */
+inline bool supported(Isa isa) {
+#ifdef SLP_KERNELS_X86
+    __builtin_cpu_init();
+    switch (isa) {
+        case Isa::scalar:
+            return true;
+        case Isa::sse42:
+            return __builtin_cpu_supports("sse4.2");
+        case Isa::avx2:
+            return __builtin_cpu_supports("avx2");
+        case Isa::avx512:
+            return __builtin_cpu_supports("avx512f");
+    }
+    return false;
+#else
+    return isa == Isa::scalar;
+#endif
+}
+
+/**
+  * Retorna a tabela de kernels de um conjunto de instruções. O chamador deve garantir que ele é suportado.
+  *
+  * @param isa O conjunto de instruções.
+  * @return A tabela de kernels.
+  */
+inline const KernelTable &table(Isa isa) {
+    static constexpr KernelTable scalar_table{"scalar", scalar::dot, scalar::dot4, scalar::axpy,
+                                              scalar::dot_bipolar, scalar::axpy_bipolar};
+#ifdef SLP_KERNELS_X86
+    // A versão SSE4.2 usa os kernels bipolares escalares
+    static constexpr KernelTable sse42_table{"sse4.2", sse42::dot, sse42::dot4, sse42::axpy,
+                                             scalar::dot_bipolar, scalar::axpy_bipolar};
+    static constexpr KernelTable avx2_table{"avx2", avx2::dot, avx2::dot4, avx2::axpy,
+                                            avx2::dot_bipolar, avx2::axpy_bipolar};
+    static constexpr KernelTable avx512_table{"avx512", avx512::dot, avx512::dot4, avx512::axpy,
+                                              avx512::dot_bipolar, avx512::axpy_bipolar};
+    switch (isa) {
+        case Isa::sse42:
+            return sse42_table;
+        case Isa::avx2:
+            return avx2_table;
+        case Isa::avx512:
+            return avx512_table;
+        default:
+            break;
+    }
+#endif
+    (void) isa;
+    return scalar_table;
+}
+
+/**
+  * Retorna a tabela de kernels do conjunto de instruções mais largo suportado pelo processador.
+  * A escolha é feita uma única vez, na primeira chamada.
+  *
+  * @return A tabela de kernels ativa.
+  */
+inline const KernelTable &active() {
+    static const KernelTable &selected = [] () -> const KernelTable & {
+        for (Isa isa: {Isa::avx512, Isa::avx2, Isa::sse42}) {
+            if (supported(isa)) {
+                return table(isa);
+            }
+        }
+        return table(Isa::scalar);
+    }();
+    return selected;
+}
+
+/**
+  * Produto escalar com uma entrada esparsa: soma values[k] * w[indices[k]] à parcial acc[indices[k] % lanes].
+  * Cada termo vai para a mesma parcial que na versão densa e os termos omitidos são zero, então o resultado é
+  * idêntico bit a bit ao de 'dot' com a entrada densa, com custo proporcional ao número de valores não nulos.
+  * O acesso aos pesos é indireto e não compensa vetorizar, então há uma única versão.
+  */
+SLP_NO_FMA inline void dot_sparse(const std::uint32_t *indices, const int *values, std::size_t nnz, const double *w,
+                                  double *acc) {
+    for (std::size_t k = 0; k < nnz; ++k) {
+        acc[indices[k] % lanes] += values[k] * w[indices[k]];
+    }
+}
+
+/**
+  * Igual a 'axpy' para uma entrada esparsa: só os pesos dos valores não nulos são alterados.
+  */
+SLP_NO_FMA inline void axpy_sparse(const std::uint32_t *indices, const int *values, std::size_t nnz, double scale,
+                                   double *w) {
+    for (std::size_t k = 0; k < nnz; ++k) {
+        w[indices[k]] = w[indices[k]] + scale * values[k];
+    }
+}
+
+} // namespace kernels
+SLP_FP_CONTRACT_OFF_END
+
+#endif //SINGLELAYERPERCEPTRON_KERNELS_H
@@ -0,0 +1,146 @@
+#ifndef SINGLELAYERPERCEPTRON_MAPPED_FILE_H
+#define SINGLELAYERPERCEPTRON_MAPPED_FILE_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+  * Arquivo inteiro mapeado em memória.
+  * O conteúdo é lido diretamente das páginas do sistema operacional, sem cópia para buffers intermediários.
+  *
+  * No modo 'copy_on_write' o conteúdo mapeado também pode ser alterado: as páginas continuam compartilhadas com
+  * o cache de arquivos (e com outros processos que mapeiam o mesmo arquivo) até serem escritas, quando o processo
+  * recebe uma cópia privada da página. O arquivo em disco nunca é alterado.
+  */
+class MappedFile {
+public:
+    enum class Access {
+        read_only,
+        copy_on_write
+    };
+
+private:
+    char *bytes = nullptr;
+    std::size_t length = 0;
+
+    void unmap() noexcept {
+        if (bytes != nullptr) {
+#ifdef _WIN32
+            UnmapViewOfFile(bytes);
+#else
+            munmap(bytes, length);
+#endif
+        }
+        bytes = nullptr;
+        length = 0;
+    }
+
+public:
+    MappedFile() = default;
+
+    /**
+      * Mapeia o arquivo em memória.
+      *
+      * @param path O caminho do arquivo.
+      * @param access Se o conteúdo mapeado pode ser alterado (sem alterar o arquivo).
+      * @throws std::runtime_error se o arquivo não puder ser aberto ou mapeado.
+      */
+    explicit MappedFile(const std::string &path, Access access = Access::read_only) {
+        const bool writable = access == Access::copy_on_write;
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("MappedFile: nao foi possivel abrir " + path);
+        }
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size)) {
+            CloseHandle(file);
+            throw std::runtime_error("MappedFile: nao foi possivel obter o tamanho de " + path);
+        }
+        length = static_cast<std::size_t>(file_size.QuadPart);
+        if (length > 0) {
+            HANDLE mapping = CreateFileMappingA(file, nullptr, writable ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+            if (mapping != nullptr) {
+                bytes = static_cast<char *>(MapViewOfFile(mapping, writable ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0));
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(file);
+#else
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("MappedFile: nao foi possivel abrir " + path);
+        }
+        struct stat info{};
+        if (fstat(fd, &info) != 0) {
+            close(fd);
+            throw std::runtime_error("MappedFile: nao foi possivel obter o tamanho de " + path);
+        }
+        length = static_cast<std::size_t>(info.st_size);
+        if (length > 0) {
+            void *address = mmap(nullptr, length, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address != MAP_FAILED) {
+                bytes = static_cast<char *>(address);
+                // Os arquivos somente leitura (conjuntos de dados) são percorridos do início ao fim
+                if (!writable) {
+                    madvise(address, length, MADV_SEQUENTIAL);
+                }
+            }
+        }
+        close(fd);
+#endif
+        if (length > 0 && bytes == nullptr) {
+            length = 0;
+            throw std::runtime_error("MappedFile: nao foi possivel mapear " + path);
+        }
+    }
+
+    MappedFile(const MappedFile &) = delete;
+
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    MappedFile(MappedFile &&other) noexcept
+            : bytes(std::exchange(other.bytes, nullptr)), length(std::exchange(other.length, 0)) {}
+
+    MappedFile &operator=(MappedFile &&other) noexcept {
+        if (this != &other) {
+            unmap();
+            bytes = std::exchange(other.bytes, nullptr);
+            length = std::exchange(other.length, 0);
+        }
+        return *this;
+    }
+
+    ~MappedFile() {
+        unmap();
+    }
+
+    [[nodiscard]] const char *data() const { return bytes; }
+
+    /**
+      * Conteúdo mapeado para escrita; só pode ser usado no modo 'copy_on_write'.
+      */
+    [[nodiscard]] char *mutable_data() { return bytes; }
+
+    [[nodiscard]] std::size_t size() const { return length; }
+};
+
+#endif //SINGLELAYERPERCEPTRON_MAPPED_FILE_H
@@ -0,0 +1,239 @@
+#ifndef SINGLELAYERPERCEPTRON_MODEL_HANDLE_H
+#define SINGLELAYERPERCEPTRON_MODEL_HANDLE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "single_layer_perceptron.h"
+
+/**
+  * Referência versionada a um modelo, no estilo RCU: as predições continuam enquanto um modelo novo é treinado.
+  *
+  * Cada versão publicada é um SingleLayerPerceptron imutável. Um leitor anuncia a versão atual no seu slot e lê o
+  * ponteiro para o modelo, sem travas nem laços; o modelo fica válido até o fim da leitura. Quem treina faz uma
+  * cópia do modelo atual com 'clone', treina a cópia e a publica com 'publish', que troca o ponteiro atomicamente.
+  * Uma versão carregada com 'load' usa os pesos do arquivo mapeado em memória, então só é imutável se o arquivo
+  * for trocado por outro (como faz 'save') e nunca regravado no lugar.
+  * Uma versão substituída só é liberada quando nenhum slot anuncia uma versão anterior à troca, isto é, quando
+  * todos os leitores que poderiam tê-la visto terminaram.
+  *
+  * Correção: o anúncio do leitor, a leitura do ponteiro, a troca e a leitura dos slots por quem publica são todos
+  * seq_cst. Se quem publica viu o slot livre (ou com uma versão posterior à troca), o leitor lê o ponteiro depois
+  * da troca na ordem total e recebe o modelo novo.
+  */
+class ModelHandle {
+private:
+    // Versão anunciada por um slot sem leitura em andamento; é maior do que qualquer versão real
+    static constexpr std::uint64_t idle = std::numeric_limits<std::uint64_t>::max();
+
+    // Um slot por leitor, em linhas de cache separadas para que os anúncios não disputem a mesma linha
+    struct alignas(64) Slot {
+        std::atomic<std::uint64_t> version{idle};
+        std::atomic<bool> claimed{false};
+    };
+
+    // Uma versão substituída, que pode ser liberada quando todos os slots anunciarem 'version' ou mais
+    struct Retired {
+        std::uint64_t version;
+        std::unique_ptr<const SingleLayerPerceptron> model;
+    };
+
+    std::atomic<const SingleLayerPerceptron *> current;
+    std::atomic<std::uint64_t> current_version{1};
+    std::unique_ptr<Slot[]> slots;
+    const std::size_t slot_count;
+    // O formato comum a todas as versões
+    const int dimension;
+    const int num_classes;
+
+    // Serializa apenas quem publica; os leitores nunca usam a trava
+    std::mutex writer;
+    std::unique_ptr<const SingleLayerPerceptron> owned;
+    std::vector<Retired> retired;
+
+    /**
+      * Libera as versões substituídas que nenhum leitor pode estar usando. Deve ser chamado com 'writer' travado.
+      *
+      * @return O número de versões que continuam esperando.
+      */
+    std::size_t reclaim_locked() {
+        std::uint64_t oldest = idle;
+        for (std::size_t s = 0; s < slot_count; ++s) {
+            oldest = std::min(oldest, slots[s].version.load());
+        }
+        std::erase_if(retired, [&](const Retired &old) { return old.version <= oldest; });
+        return retired.size();
+    }
+
+public:
+    /**
+      * Uma leitura em andamento: mantém o modelo lido válido até ser destruída.
+      */
+    class Snapshot {
+    private:
+        friend class ModelHandle;
+
+        Slot *slot = nullptr;
+        const SingleLayerPerceptron *model = nullptr;
+
+        Snapshot(Slot *slot, const SingleLayerPerceptron *model) : slot(slot), model(model) {}
+
+    public:
+        Snapshot(const Snapshot &) = delete;
+
+        Snapshot &operator=(const Snapshot &) = delete;
+
+        Snapshot(Snapshot &&other) noexcept
+                : slot(std::exchange(other.slot, nullptr)), model(std::exchange(other.model, nullptr)) {}
+
+        Snapshot &operator=(Snapshot &&) = delete;
+
+        ~Snapshot() {
+            if (slot != nullptr) {
+                slot->version.store(idle, std::memory_order_release);
+            }
+        }
+
+        const SingleLayerPerceptron &operator*() const { return *model; }
+
+        const SingleLayerPerceptron *operator->() const { return model; }
+    };
+
+    /**
+      * O slot de um leitor. Cada thread que lê o modelo deve ter o seu próprio Reader, criado uma vez e usado
+      * para todas as leituras; só uma leitura por Reader pode estar em andamento.
+      */
+    class Reader {
+    private:
+        ModelHandle *handle;
+        Slot *slot = nullptr;
+
+    public:
+        /**
+          * Reserva um slot livre.
+          *
+          * @throws std::runtime_error se todos os slots estiverem em uso.
+          */
+        explicit Reader(ModelHandle &handle) : handle(&handle) {
+            for (std::size_t s = 0; s < handle.slot_count && slot == nullptr; ++s) {
+                bool expected = false;
+                if (handle.slots[s].claimed.compare_exchange_strong(expected, true)) {
+                    slot = &handle.slots[s];
+                }
+            }
+            if (slot == nullptr) {
+                throw std::runtime_error("ModelHandle: todos os slots de leitura estao em uso");
+            }
+        }
+
+        Reader(const Reader &) = delete;
+
+        Reader &operator=(const Reader &) = delete;
+
+        ~Reader() {
+            slot->claimed.store(false, std::memory_order_release);
+        }
+
+        /**
+          * Lê a versão atual do modelo, sem travas: são sempre três operações atômicas.
+          *
+          * @return A leitura; o modelo continua válido até ela ser destruída, mesmo se outra versão for publicada.
+          */
+        [[nodiscard]] Snapshot read() const {
+            slot->version.store(handle->current_version.load());
+            return {slot, handle->current.load()};
+        }
+    };
+
+    /**
+      * @param model A primeira versão do modelo.
+      * @param max_readers O número máximo de Readers existindo ao mesmo tempo.
+      */
+    explicit ModelHandle(SingleLayerPerceptron model, std::size_t max_readers = 64)
+            : slots(std::make_unique<Slot[]>(max_readers)), slot_count(max_readers),
+              dimension(model.input_dimension()), num_classes(model.class_count()),
+              owned(std::make_unique<const SingleLayerPerceptron>(std::move(model))) {
+        current.store(owned.get());
+    }
+
+    ModelHandle(const ModelHandle &) = delete;
+
+    ModelHandle &operator=(const ModelHandle &) = delete;
+
+    /**
+      * Todos os Readers devem ter sido destruídos antes.
+      */
+    ~ModelHandle() = default;
+
+    /**
+      * @return Uma cópia da versão atual, para ser treinada e publicada.
+      */
+    [[nodiscard]] SingleLayerPerceptron clone() {
+        // A versão atual só é trocada e liberada com 'writer' travado
+        std::lock_guard lock(writer);
+        return *current.load();
+    }
+
+    /**
+      * Publica uma nova versão do modelo; as leituras seguintes a recebem e as leituras em andamento continuam com a
+      * versão que leram. Não espera os leitores: a versão substituída é liberada nesta ou em uma publicação futura,
+      * ou em 'reclaim'.
+      *
+      * @param model A nova versão, com a mesma dimensão e o mesmo número de classes da atual.
+      * @return O número da nova versão; a primeira versão é 1.
+      * @throws std::invalid_argument se o formato do modelo for diferente.
+      */
+    std::uint64_t publish(SingleLayerPerceptron model) {
+        std::lock_guard lock(writer);
+        if (model.input_dimension() != dimension || model.class_count() != num_classes) {
+            throw std::invalid_argument("ModelHandle: o formato do modelo publicado difere do atual");
+        }
+
+        auto next = std::make_unique<const SingleLayerPerceptron>(std::move(model));
+        current.store(next.get());
+        const std::uint64_t version = current_version.fetch_add(1) + 1;
+        retired.push_back({version, std::exchange(owned, std::move(next))});
+        reclaim_locked();
+        return version;
+    }
+
+    /**
+      * Libera as versões substituídas que nenhum leitor pode estar usando.
+      *
+      * @return O número de versões que continuam esperando leitores.
+      */
+    std::size_t reclaim() {
+        std::lock_guard lock(writer);
+        return reclaim_locked();
+    }
+
+    /**
+      * Espera todos os leitores das versões substituídas terminarem e as libera. Não deve ser chamado por uma
+      * thread com uma leitura em andamento.
+      */
+    void synchronize() {
+        while (reclaim() != 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+      * @return O número da versão atual.
+      */
+    [[nodiscard]] std::uint64_t version() const { return current_version.load(); }
+
+    [[nodiscard]] int input_dimension() const { return dimension; }
+
+    [[nodiscard]] int class_count() const { return num_classes; }
+};
+
+#endif //SINGLELAYERPERCEPTRON_MODEL_HANDLE_H
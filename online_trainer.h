@@ -0,0 +1,226 @@
+#ifndef SINGLELAYERPERCEPTRON_ONLINE_TRAINER_H
+#define SINGLELAYERPERCEPTRON_ONLINE_TRAINER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "csv_loader.h"
+#include "model_handle.h"
+#include "single_layer_perceptron.h"
+
+/**
+  * Contadores de um treinamento online, acumulados desde a criação do OnlineTrainer.
+  */
+struct OnlineStats {
+    // Amostras aplicadas ao modelo
+    std::size_t samples = 0;
+    // Saídas erradas e atualizações dos pesos, como em 'EpochStats'
+    std::size_t misclassifications = 0;
+    std::size_t updates = 0;
+    // Linhas malformadas ignoradas
+    std::size_t skipped = 0;
+    // Cópias do modelo publicadas
+    std::size_t snapshots = 0;
+    // A última linha malformada, ou uma linha 0 se não houve nenhuma
+    CsvError last_error{0, {}};
+};
+
+/**
+  * Opções de 'OnlineTrainer::train'.
+  */
+struct OnlineOptions {
+    // Ao chegar ao fim da entrada, espera novas linhas em vez de parar, como 'tail -f'
+    bool follow = false;
+    // O intervalo entre as tentativas de leitura no fim da entrada, com 'follow'
+    std::chrono::milliseconds poll_interval{200};
+    // Se não for nulo, o treinamento para quando ficar verdadeiro; pode ser alterado por um tratador de sinal
+    const std::atomic<bool> *stop = nullptr;
+
+    // Publica uma cópia do modelo a cada 'snapshot_every' amostras e a cada 'snapshot_interval'; 0 desativa
+    std::size_t snapshot_every = 0;
+    std::chrono::steady_clock::duration snapshot_interval{0};
+    // Destinos das cópias: um arquivo gravado com 'save' e trocado atomicamente, um ModelHandle e uma função
+    std::string snapshot_path;
+    ModelHandle *handle = nullptr;
+    std::function<void(const SingleLayerPerceptron &, const OnlineStats &)> on_snapshot;
+};
+
+/**
+  * Treinamento online: aplica a regra de 'train' (act_func e ch_weights) a cada amostra assim que ela chega,
+  * uma única vez, sem guardar o conjunto de dados. A memória usada não depende do número de amostras, então a
+  * entrada pode ser um fluxo sem fim (stdin, um pipe ou um arquivo que cresce).
+  *
+  * O modelo é alterado diretamente, então outras threads devem ler o modelo pelas cópias publicadas (veja
+  * 'ModelHandle').
+  */
+class OnlineTrainer {
+private:
+    SingleLayerPerceptron &model;
+    const std::size_t dimension;
+    const std::size_t num_classes;
+    OnlineStats totals;
+
+    // Buffers da amostra sendo lida
+    std::string line;
+    std::string part;
+    std::vector<int> data;
+    std::vector<int> expected;
+
+public:
+    /**
+      * @param model O modelo treinado; deve continuar válido enquanto o OnlineTrainer existir.
+      */
+    explicit OnlineTrainer(SingleLayerPerceptron &model)
+            : model(model), dimension(static_cast<std::size_t>(model.input_dimension())),
+              num_classes(static_cast<std::size_t>(model.class_count())), data(dimension), expected(num_classes) {}
+
+    /**
+      * Aplica uma amostra ao modelo.
+      *
+      * @param sample Um ponto de dados com a dimensão do modelo.
+      * @param target A saída desejada de cada neurônio.
+      * @return Verdadeiro se algum peso foi alterado.
+      */
+    bool learn(std::span<const int> sample, std::span<const int> target) {
+        if (sample.size() != dimension || target.size() != num_classes) {
+            throw std::invalid_argument("OnlineTrainer: o formato da amostra difere do do modelo");
+        }
+
+        // Um conjunto de dados com uma amostra, percorrido pela mesma época de 'train'
+        const std::array<std::span<const int>, 1> dataset{sample};
+        const std::array<std::span<const int>, 1> targets{target};
+        const EpochStats stats = model.internal_train_range(dataset, targets, 0, 1, model.weights.data());
+        ++totals.samples;
+        totals.misclassifications += stats.misclassifications;
+        totals.updates += stats.updates;
+        if (stats.updates != 0) {
+            model.refresh_bitplanes();
+        }
+        return stats.updates != 0;
+    }
+
+    /**
+      * Publica uma cópia do modelo atual em todos os destinos de 'options'.
+      *
+      * @throws std::runtime_error se o arquivo não puder ser gravado.
+      */
+    void snapshot(const OnlineOptions &options) {
+        if (!options.snapshot_path.empty()) {
+            // 'save' grava um arquivo temporário e o renomeia, então um leitor nunca vê um arquivo incompleto
+            model.save(options.snapshot_path);
+        }
+        if (options.handle != nullptr) {
+            options.handle->publish(model);
+        }
+        ++totals.snapshots;
+        if (options.on_snapshot) {
+            options.on_snapshot(model, totals);
+        }
+    }
+
+    /**
+      * Lê amostras de um fluxo no formato de 'readData', uma linha por amostra com os 'dimension' valores do ponto de
+      * dados seguidos das 'num_classes' saídas desejadas, e aplica cada uma ao modelo ao ser lida.
+      * Linhas vazias são ignoradas; linhas malformadas são contadas em 'skipped'. Com 'follow', uma linha só é
+      * aplicada depois que o seu fim de linha chega, então um arquivo pode ser lido enquanto é escrito.
+      *
+      * Para no fim da entrada (sem 'follow') ou quando 'options.stop' ficar verdadeiro, e então publica uma última
+      * cópia se houver algum destino. 'options.stop' é verificado antes de cada leitura e quando uma leitura termina
+      * sem uma linha completa; para que um sinal interrompa uma leitura bloqueada (de um pipe ou terminal), o seu
+      * tratador deve ser instalado sem SA_RESTART (veja slp_online.cpp).
+      *
+      * @param input A entrada.
+      * @param options As opções do treinamento.
+      * @return Os contadores acumulados.
+      */
+    OnlineStats train(std::istream &input, const OnlineOptions &options = {}) {
+        using Clock = std::chrono::steady_clock;
+        const bool timed = options.snapshot_interval > Clock::duration::zero();
+        Clock::time_point next_snapshot = timed ? Clock::now() + options.snapshot_interval : Clock::time_point{};
+        std::size_t since_snapshot = 0;
+        std::size_t line_number = 0;
+        const std::size_t columns = dimension + num_classes;
+        const bool publishes = !options.snapshot_path.empty() || options.handle != nullptr || options.on_snapshot;
+        const auto publish_if_due = [&] {
+            const bool due_count = options.snapshot_every != 0 && since_snapshot >= options.snapshot_every;
+            const bool due_time = timed && since_snapshot != 0 && Clock::now() >= next_snapshot;
+            if (publishes && (due_count || due_time)) {
+                snapshot(options);
+                since_snapshot = 0;
+                if (timed) {
+                    next_snapshot = Clock::now() + options.snapshot_interval;
+                }
+            }
+        };
+
+        line.clear();
+        while (options.stop == nullptr || !options.stop->load()) {
+            // Uma linha sem o fim de linha continua em 'line' e é completada na próxima leitura
+            std::getline(input, part);
+            const bool complete = !input.eof();
+            line += part;
+            if (!complete && options.stop != nullptr && options.stop->load()) {
+                // A leitura foi interrompida por um sinal (EINTR, visto como fim da entrada): uma linha incompleta
+                // é descartada em vez de ser aplicada pela metade
+                break;
+            }
+            if (!complete) {
+                if (!options.follow || input.bad()) {
+                    if (line.empty()) {
+                        break;
+                    }
+                } else {
+                    input.clear();
+                    publish_if_due();
+                    std::this_thread::sleep_for(options.poll_interval);
+                    continue;
+                }
+            }
+
+            ++line_number;
+            const char *cursor = line.data();
+            const char *line_end = line.data() + line.size();
+            if (line_number == 1) {
+                csv_detail::skip_bom(cursor, line_end);
+            }
+            if (line_end > cursor && line_end[-1] == '\r') {
+                --line_end;
+            }
+            if (line_end != cursor) {
+                std::size_t column = 0;
+                const char *error = csv_detail::parse_row(cursor, line_end, data.data(), dimension, expected.data(),
+                                                          columns, column);
+                if (error != nullptr) {
+                    ++totals.skipped;
+                    totals.last_error = {line_number, "coluna " + std::to_string(column + 1) + ": " + error};
+                } else {
+                    learn(data, expected);
+                    ++since_snapshot;
+                }
+            }
+            line.clear();
+            if (!complete) {
+                break;
+            }
+            publish_if_due();
+        }
+
+        if (publishes) {
+            snapshot(options);
+        }
+        return totals;
+    }
+
+    [[nodiscard]] const OnlineStats &stats() const { return totals; }
+};
+
+#endif //SINGLELAYERPERCEPTRON_ONLINE_TRAINER_H
@@ -0,0 +1,48 @@
+#ifndef SINGLELAYERPERCEPTRON_RANDOM_H
+#define SINGLELAYERPERCEPTRON_RANDOM_H
+
+#include <cstdint>
+
+/**
+  * Gerador pseudoaleatório SplitMix64: 64 bits de estado e uma sequência idêntica em qualquer plataforma, ao
+  * contrário das distribuições de <random>, cujo resultado depende da biblioteca padrão.
+  */
+class SplitMix64 {
+private:
+    std::uint64_t state;
+
+public:
+    explicit SplitMix64(std::uint64_t seed) : state(seed) {}
+
+    /**
+      * Deriva uma semente independente para o fluxo 'stream' (por exemplo, um bloco de linhas ou uma época),
+      * para que cada fluxo possa ser gerado isoladamente e em qualquer ordem.
+      */
+    static std::uint64_t derive(std::uint64_t seed, std::uint64_t stream) {
+        SplitMix64 mixer(seed ^ (stream * 0xD1B54A32D192ED03ULL));
+        return mixer();
+    }
+
+    std::uint64_t operator()() {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    /**
+      * Número decimal uniforme em [0, 1), com 53 bits aleatórios.
+      */
+    double uniform() {
+        return static_cast<double>((*this)() >> 11) * 0x1.0p-53;
+    }
+
+    /**
+      * Inteiro uniforme em [0, n), para n até 2^32, por multiplicação (o viés é menor que n / 2^32).
+      */
+    std::uint64_t below(std::uint64_t n) {
+        return (((*this)() >> 32) * n) >> 32;
+    }
+};
+
+#endif //SINGLELAYERPERCEPTRON_RANDOM_H
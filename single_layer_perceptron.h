@@ -0,0 +1,1271 @@
+#ifndef SINGLELAYERPERCEPTRON_SINGLE_LAYER_PERCEPTRON_H
+#define SINGLELAYERPERCEPTRON_SINGLE_LAYER_PERCEPTRON_H
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <concepts>
+
+#include "binary_dataset.h"
+#include "bipolar.h"
+#include "checkpoint.h"
+#include "cycle_detector.h"
+#include "dataset.h"
+#include "gram_matrix.h"
+#include "kernels.h"
+#include "sparse.h"
+#include "training.h"
+#include "weight_matrix.h"
+
+/**
+  * Pontos de dados aceitos pelo treinamento junto com saídas desejadas separadas: um vetor 2D de números inteiros,
+  * um conjunto bipolar empacotado ou um conjunto esparso.
+  */
+template<typename Data>
+concept TrainingData = std::same_as<Data, std::vector<std::vector<int>>> ||
+                       std::same_as<Data, PackedBipolarDataset> || std::same_as<Data, SparseDataset>;
+
+/**
+  * Saídas desejadas aceitas pelo treinamento: um vetor 2D de números inteiros ou uma matriz em um único buffer,
+  * como 'Dataset::label_view' ou 'SparseData::label_view'.
+  */
+template<typename Target>
+concept TrainingTarget = std::same_as<Target, std::vector<std::vector<int>>> || std::same_as<Target, MatrixView<int>>;
+
+/**
+  * Conjuntos que guardam os pontos de dados e as saídas desejadas juntos: um Dataset (ou um CsvData, que o estende)
+  * ou um BinaryDataset.
+  */
+template<typename Data>
+concept LabeledData = std::derived_from<Data, Dataset> || std::same_as<Data, BinaryDataset>;
+
+/**
+  * Verifica se os pontos de dados e as saídas desejadas têm a forma de um modelo.
+  *
+  * @param dataset Os pontos de dados.
+  * @param target As saídas desejadas.
+  * @param dimension A dimensão do modelo.
+  * @param num_classes O número de neurônios do modelo.
+  * @param caller O nome da função que faz a verificação, usado na mensagem de erro.
+  * @throws std::invalid_argument se a dimensão dos dados, o número de saídas desejadas ou o número de valores de
+  *         alguma saída desejada diferir do esperado.
+  */
+template<TrainingData Data, TrainingTarget Target>
+void check_training_shape(const Data &dataset, const Target &target, std::size_t dimension, std::size_t num_classes,
+                          const std::string &caller) {
+    if constexpr (std::same_as<Data, std::vector<std::vector<int>>>) {
+        for (const auto &data: dataset) {
+            if (data.size() != dimension) {
+                throw std::invalid_argument(caller + ": a dimensao dos dados difere da do modelo");
+            }
+        }
+    } else if (dataset.dimension() != dimension) {
+        throw std::invalid_argument(caller + ": a dimensao do conjunto difere da do modelo");
+    }
+    if (target.size() != dataset.size()) {
+        throw std::invalid_argument(caller + ": o numero de saidas desejadas difere do numero de pontos de dados");
+    }
+    if constexpr (std::same_as<Target, std::vector<std::vector<int>>>) {
+        for (const auto &expected: target) {
+            if (expected.size() != num_classes) {
+                throw std::invalid_argument(caller + ": o numero de saidas desejadas difere do de neuronios");
+            }
+        }
+    } else if (target.cols != num_classes) {
+        throw std::invalid_argument(caller + ": o numero de saidas desejadas difere do de neuronios");
+    }
+}
+
+/**
+  * Versão de 'check_training_shape' para um conjunto com as saídas desejadas guardadas nele.
+  */
+template<LabeledData Data>
+void check_training_shape(const Data &dataset, std::size_t dimension, std::size_t num_classes,
+                          const std::string &caller) {
+    if (dataset.dimension() != dimension) {
+        throw std::invalid_argument(caller + ": a dimensao do conjunto difere da do modelo");
+    }
+    if (dataset.label_width() != num_classes) {
+        throw std::invalid_argument(caller + ": o numero de saidas do conjunto difere do de neuronios");
+    }
+}
+
+/**
+  * Chama 'train' com as visões dos pontos de dados e das saídas desejadas de um conjunto rotulado, sem cópia: as
+  * linhas de um Dataset, ou os blocos mapeados de um BinaryDataset (empacotados, se o conjunto for bipolar).
+  *
+  * @param dataset O conjunto rotulado.
+  * @param train Uma função chamada com (pontos de dados, saídas desejadas).
+  * @return O valor retornado por 'train'.
+  */
+template<typename Train>
+decltype(auto) with_labels(const Dataset &dataset, Train &&train) {
+    return train(dataset, dataset.label_view());
+}
+
+template<typename Train>
+decltype(auto) with_labels(const BinaryDataset &dataset, Train &&train) {
+    if (dataset.is_bipolar()) {
+        return train(dataset.bipolar_features(), dataset.labels());
+    }
+    return train(dataset.features(), dataset.labels());
+}
+
+class SingleLayerPerceptron {
+private:
+    // Acesso aos métodos internos para medir o seu desempenho (veja bench.cpp)
+    friend struct PerceptronBenchmark;
+    // Acesso aos pesos para compará-los nos testes (veja tests.cpp)
+    friend struct PerceptronTest;
+    // Treina vários modelos com uma única passagem pelos dados (veja grid_trainer.h)
+    friend class GridTrainer;
+    // Aplica as amostras de um fluxo uma a uma (veja online_trainer.h)
+    friend class OnlineTrainer;
+
+    // Tamanho de uma linha de cache, em bytes
+    static constexpr std::size_t cache_line = 64;
+
+    const int dimension;
+    const int num_classes;
+
+    // Distância, em números decimais, entre o início de duas linhas consecutivas da matriz de pesos.
+    // Cada linha guarda os pesos do neurônio, o peso do bias na posição 'dimension' e o preenchimento
+    // necessário para que a próxima linha comece em uma nova linha de cache.
+    const std::size_t stride;
+
+    // Matriz de pesos (com o bias) de todos os neurônios em um único bloco contíguo e alinhado.
+    // Pode ser alocada na memória ou vir diretamente de um modelo salvo mapeado em memória (veja 'load').
+    WeightMatrix weights;
+    double learning_rate;
+
+    const double theta;
+
+    // Pesos decompostos em planos de bits, usados na predição de entradas bipolares empacotadas
+    // quando todos os pesos são inteiros. São descartados ao fim de cada treinamento e construídos na primeira
+    // predição bipolar seguinte.
+    BitplaneCache bitplanes;
+
+    // Número de amostras processadas juntas pelo kernel de predição em lote
+    static constexpr std::size_t batch_tile_rows = kernels::dot4_rows;
+    // Número de colunas de cada bloco da dimensão processado pelo kernel de predição em lote (múltiplo de kernels::lanes)
+    static constexpr std::size_t batch_tile_cols = 1024;
+
+    /**
+      * Acumuladores do perceptron médio (veja 'TrainOptions::average').
+      * A média dos pesos após cada passo exigiria somar toda a matriz de pesos a cada amostra. Em vez disso, cada
+      * atualização feita no passo c também é somada, multiplicada por c, a 'sums' (veja 'ch_weights'); ao final a
+      * média é weights - sums / step, então o custo é proporcional ao número de atualizações.
+      */
+    struct Averaging {
+        // Mesma disposição da matriz de pesos
+        WeightMatrix sums;
+        // Número do passo atual, começando em 1; cada amostra visitada é um passo
+        std::size_t step = 1;
+    };
+
+    /**
+      * Aplica a função de passo à entrada líquida de um neurônio.
+      *
+      * @param net A entrada líquida (produto escalar mais bias).
+      * @return 1 se net for maior que theta, -1 se for menor que theta - 1, e 0 nos demais casos.
+      */
+    [[nodiscard]] int activation(double net) const {
+        return (net > theta) ? 1 : ((net >= theta - 1) ? 0 : -1);
+    }
+
+    /**
+      * Calcula a entrada líquida de um neurônio: o produto escalar entre os dados e os pesos mais o bias.
+      * O produto escalar usa o kernel SIMD escolhido em tempo de execução (veja kernels.h); as versões bipolar e
+      * esparsa somam os mesmos termos, nas mesmas somas parciais, que a versão densa e produzem o mesmo valor.
+      *
+      * @param data Um ponto de dados: um vetor de inteiros, um ponto bipolar empacotado ou um ponto esparso.
+      * @param row Ponteiro para a linha da matriz de pesos do neurônio; o bias fica na posição 'dimension'.
+      * @return A entrada líquida do neurônio.
+      */
+    [[nodiscard]] double net_input(std::span<const int> data, const double *row) const {
+        double partial[kernels::lanes] = {};
+        kernels::active().dot(data.data(), row, data.size(), partial);
+        return row[dimension] + kernels::reduce(partial);
+    }
+
+    [[nodiscard]] double net_input(BipolarSample data, const double *row) const {
+        double partial[kernels::lanes] = {};
+        kernels::active().dot_bipolar(data.words.data(), row, static_cast<std::size_t>(dimension), partial);
+        return row[dimension] + kernels::reduce(partial);
+    }
+
+    [[nodiscard]] double net_input(SparseSample data, const double *row) const {
+        double partial[kernels::lanes] = {};
+        kernels::dot_sparse(data.indices.data(), data.values.data(), data.nnz(), row, partial);
+        return row[dimension] + kernels::reduce(partial);
+    }
+
+    /**
+      * Esta função calcula a saída da função de ativação para um determinado ponto de dados, pesos e bias.
+      * Ela calcula o produto escalar entre os dados e os pesos, adiciona o bias e, em seguida, aplica a função de ativação.
+      * O produto escalar usa o kernel SIMD escolhido em tempo de execução (veja kernels.h).
+      * A função de ativação é uma função de passo (step function) que retorna 1 se a entrada líquida for maior que um limite theta,
+      * -1 se a entrada líquida for menor que theta - 1, e 0 nos demais casos.
+      *
+      * @param data Um vetor de inteiros representando um ponto de dados do conjunto de dados.
+      * @param row Ponteiro para a linha da matriz de pesos do neurônio; o bias fica na posição 'dimension'.
+      * @return Um inteiro representando a saída da função de ativação.
+      */
+    [[nodiscard]] int act_func(std::span<const int> data, const double *row) const {
+        // Aplica a função de ativação à entrada líquida e retorna o resultado
+        return activation(net_input(data, row));
+    }
+
+    /**
+      * Versão de 'act_func' para um ponto de dados bipolar empacotado.
+      * Como cada valor é +1 ou -1, soma exatamente os mesmos termos que a versão densa e produz o mesmo resultado.
+      *
+      * @param data Um ponto de dados bipolar empacotado.
+      * @param row Ponteiro para a linha da matriz de pesos do neurônio; o bias fica na posição 'dimension'.
+      * @return Um inteiro representando a saída da função de ativação.
+      */
+    [[nodiscard]] int act_func(BipolarSample data, const double *row) const {
+        return activation(net_input(data, row));
+    }
+
+    /**
+      * Versão de 'act_func' para um ponto de dados esparso: só os valores não nulos são multiplicados, então o custo
+      * é proporcional ao seu número. Cada termo é somado à mesma soma parcial que na versão densa e produz o
+      * mesmo resultado.
+      *
+      * @param data Um ponto de dados esparso.
+      * @param row Ponteiro para a linha da matriz de pesos do neurônio; o bias fica na posição 'dimension'.
+      * @return Um inteiro representando a saída da função de ativação.
+      */
+    [[nodiscard]] int act_func(SparseSample data, const double *row) const {
+        return activation(net_input(data, row));
+    }
+
+    /**
+      * Esta função é responsável por atualizar os pesos e o bias do modelo com base na distância entre a saída prevista e a saída real.
+      * Ela verifica se a saída prevista não é igual à saída real e se a taxa de aprendizado e a saída real não são zero.
+      * Caso estas condições sejam atendidas, atualiza os pesos adicionando o produto da taxa de aprendizado, a saída real e o valor dos dados ao peso atual.
+      * A atualização dos pesos usa o kernel SIMD escolhido em tempo de execução (veja kernels.h).
+      * Também atualiza o bias adicionando o produto da taxa de aprendizado e a saída real ao bias atual.
+      *
+      * @param data Um vetor de inteiros representando um ponto de dado do conjunto de dados.
+      * @param target Um inteiro representando a saída real para o ponto de dado.
+      * @param output Um inteiro representando a saída prevista para o ponto de dado.
+      * @param row Ponteiro para a linha da matriz de pesos do neurônio; o bias fica na posição 'dimension'.
+      * @param sums Se não for nulo, a linha do neurônio nos acumuladores do perceptron médio (veja 'Averaging'),
+      *             que recebe a atualização multiplicada por 'step'.
+      * @param step O número do passo atual do perceptron médio.
+      * @return Verdadeiro se os pesos foram atualizados.
+      */
+    bool ch_weights(std::span<const int> data, int target, int output, double *row, double *sums = nullptr,
+                    double step = 0) const {
+        // Verifica se a saída prevista não é igual à saída esperada e se a taxa de aprendizagem e a saída esperada não são zero.
+        if (output != target && learning_rate != 0 && target != 0) {
+            // Atualiza os pesos adicionando o produto da taxa de aprendizagem, a saída esperada e o valor dos dados ao peso atual.
+            kernels::active().axpy(data.data(), learning_rate * target, row, data.size());
+            // Atualiza o bias adicionando o produto da taxa de aprendizagem e a saída real ao bias atual.
+            row[dimension] += learning_rate * target;
+            // Registra a atualização, com o número do passo, para o perceptron médio
+            if (sums != nullptr) {
+                kernels::active().axpy(data.data(), learning_rate * target * step, sums, data.size());
+                sums[dimension] += learning_rate * target * step;
+            }
+            return true;
+        }
+        return false;
+    }
+
+    /**
+      * Versão de 'ch_weights' para um ponto de dados bipolar empacotado.
+      *
+      * @param data Um ponto de dados bipolar empacotado.
+      * @param target Um inteiro representando a saída real para o ponto de dado.
+      * @param output Um inteiro representando a saída prevista para o ponto de dado.
+      * @param row Ponteiro para a linha da matriz de pesos do neurônio; o bias fica na posição 'dimension'.
+      * @param sums Se não for nulo, a linha do neurônio nos acumuladores do perceptron médio.
+      * @param step O número do passo atual do perceptron médio.
+      * @return Verdadeiro se os pesos foram atualizados.
+      */
+    bool ch_weights(BipolarSample data, int target, int output, double *row, double *sums = nullptr,
+                    double step = 0) const {
+        if (output != target && learning_rate != 0 && target != 0) {
+            kernels::active().axpy_bipolar(data.words.data(), learning_rate * target, row,
+                                           static_cast<std::size_t>(dimension));
+            row[dimension] += learning_rate * target;
+            if (sums != nullptr) {
+                kernels::active().axpy_bipolar(data.words.data(), learning_rate * target * step, sums,
+                                               static_cast<std::size_t>(dimension));
+                sums[dimension] += learning_rate * target * step;
+            }
+            return true;
+        }
+        return false;
+    }
+
+    /**
+      * Versão de 'ch_weights' para um ponto de dados esparso: só os pesos dos valores não nulos são alterados.
+      *
+      * @param data Um ponto de dados esparso.
+      * @param target Um inteiro representando a saída real para o ponto de dado.
+      * @param output Um inteiro representando a saída prevista para o ponto de dado.
+      * @param row Ponteiro para a linha da matriz de pesos do neurônio; o bias fica na posição 'dimension'.
+      * @param sums Se não for nulo, a linha do neurônio nos acumuladores do perceptron médio.
+      * @param step O número do passo atual do perceptron médio.
+      * @return Verdadeiro se os pesos foram atualizados.
+      */
+    bool ch_weights(SparseSample data, int target, int output, double *row, double *sums = nullptr,
+                    double step = 0) const {
+        if (output != target && learning_rate != 0 && target != 0) {
+            kernels::axpy_sparse(data.indices.data(), data.values.data(), data.nnz(), learning_rate * target, row);
+            row[dimension] += learning_rate * target;
+            if (sums != nullptr) {
+                kernels::axpy_sparse(data.indices.data(), data.values.data(), data.nnz(),
+                                     learning_rate * target * step, sums);
+                sums[dimension] += learning_rate * target * step;
+            }
+            return true;
+        }
+        return false;
+    }
+
+    /**
+      * Essa função é responsável por treinar o modelo perceptron durante uma época.
+      * Ela itera através do conjunto de dados e atualiza os pesos e o bias do modelo baseando-se na distância entre as saídas previstas e reais.
+      * A função retorna as estatísticas da época; o modelo convergiu quando nenhuma saída prevista difere da desejada.
+      *
+      * @param dataset Os dados de treinamento: um vetor 2D de números inteiros, um PackedBipolarDataset, um
+      *                SparseDataset ou uma visão de um BinaryDataset.
+      * @param target A saída desejada para cada ponto de dados no dataset: um vetor 2D de números inteiros ou uma
+      *               visão de um BinaryDataset.
+      * @param cycles Se não for nulo, recebe as atualizações dos pesos para detectar ciclos.
+      * @param order A ordem em que as amostras são visitadas (veja EpochOrder); vazia visita na ordem do dataset.
+      * @param averaging Se não for nulo, os acumuladores do perceptron médio.
+      * @return As estatísticas da época, sem o número da época e o tempo decorrido.
+      */
+    template<typename Dataset, typename Target>
+    EpochStats internal_train(const Dataset &dataset, const Target &target, CycleDetector *cycles = nullptr,
+                              std::span<const std::size_t> order = {}, Averaging *averaging = nullptr) {
+        return internal_train_range(dataset, target, 0, dataset.size(), weights.data(), cycles, order, averaging);
+    }
+
+    /**
+      * Executa uma época de 'internal_train' sobre as posições [begin, end) da ordem das amostras com uma matriz de
+      * pesos qualquer, com a mesma disposição (e o mesmo 'stride') da matriz do modelo.
+      *
+      * @param dataset Os dados de treinamento (veja 'internal_train').
+      * @param target A saída desejada para cada ponto de dados no dataset (veja 'internal_train').
+      * @param begin A primeira posição.
+      * @param end A posição seguinte à última.
+      * @param matrix Ponteiro para a primeira linha da matriz de pesos.
+      * @param cycles Se não for nulo, recebe as atualizações dos pesos para detectar ciclos.
+      * @param order A ordem em que as amostras são visitadas; vazia visita na ordem do dataset.
+      * @param averaging Se não for nulo, os acumuladores do perceptron médio.
+      * @return As estatísticas da época, sem o número da época e o tempo decorrido.
+      */
+    template<typename Dataset, typename Target>
+    EpochStats internal_train_range(const Dataset &dataset, const Target &target, std::size_t begin, std::size_t end,
+                                    double *matrix, CycleDetector *cycles = nullptr,
+                                    std::span<const std::size_t> order = {}, Averaging *averaging = nullptr) {
+        // Acumula o número de saídas erradas e de atualizações dos pesos durante a época
+        EpochStats stats;
+        stats.evaluations = (end - begin) * static_cast<std::size_t>(num_classes);
+
+        // Itera sobre o conjunto de dados, na ordem da época
+        for (std::size_t k = begin; k < end; ++k) {
+            const std::size_t n = order.empty() ? k : order[k];
+            const auto &data = dataset[n];
+            const auto &expected = target[n];
+
+            // Para cada ponto de dados, itera sobre o número de classes
+            for (int i = 0; i < num_classes; ++i) {
+                double *weight = matrix + static_cast<std::size_t>(i) * stride;
+                double *sums = averaging != nullptr ? averaging->sums.data() + static_cast<std::size_t>(i) * stride
+                                                    : nullptr;
+
+                // Calcula a saída da função de ativação para o ponto de dados atual e os pesos
+                int output = act_func(data, weight);
+
+                // Atualiza os pesos e o bias com base na diferença entre a saída prevista e a saída real
+                if (ch_weights(data, expected[i], output, weight, sums,
+                               averaging != nullptr ? static_cast<double>(averaging->step) : 0.0)) {
+                    ++stats.updates;
+                    if (cycles != nullptr) {
+                        cycles->record_update(static_cast<std::size_t>(i), n, expected[i]);
+                    }
+                }
+
+                // Conta as saídas previstas que não correspondem à saída real
+                stats.misclassifications += output != expected[i];
+            }
+            if (averaging != nullptr) {
+                ++averaging->step;
+            }
+        }
+
+        return stats;
+    }
+
+    /**
+      * Substitui os pesos pela média dos pesos após cada passo do treinamento, incluindo os pesos iniciais.
+      *
+      * @param averaging Os acumuladores do perceptron médio.
+      */
+    void apply_average(const Averaging &averaging) {
+        const auto step = static_cast<double>(averaging.step);
+        for (int i = 0; i < num_classes; ++i) {
+            double *weight = row(i);
+            const double *sums = averaging.sums.data() + static_cast<std::size_t>(i) * stride;
+            for (int j = 0; j <= dimension; ++j) {
+                weight[j] -= sums[j] / step;
+            }
+        }
+    }
+
+    /**
+      * Executa épocas de 'internal_train' até que o modelo convirja ou que um dos limites de 'options' seja atingido.
+      *
+      * @param dataset Os dados de treinamento (veja 'internal_train').
+      * @param target A saída desejada para cada ponto de dados no dataset (veja 'internal_train').
+      * @param options Os limites e o callback do treinamento.
+      * @return O motivo da parada e as estatísticas da última época.
+      */
+    template<typename Dataset, typename Target>
+    TrainResult internal_train_until(const Dataset &dataset, const Target &target, const TrainOptions &options) {
+        std::optional<Averaging> averaging;
+        if (options.average) {
+            averaging.emplace(Averaging{WeightMatrix(static_cast<std::size_t>(num_classes) * stride)});
+        }
+        const TrainResult result = run_epochs(dataset, static_cast<std::size_t>(dimension),
+                                              static_cast<std::size_t>(num_classes), options,
+                                              [&](CycleDetector *cycles, std::span<const std::size_t> order) {
+                                                  return internal_train(dataset, target, cycles, order,
+                                                                        averaging ? &*averaging : nullptr);
+                                              });
+        if (averaging) {
+            apply_average(*averaging);
+        }
+        refresh_bitplanes();
+        return result;
+    }
+
+    /**
+      * Treina o modelo na forma dual. Os pesos de cada neurônio são sempre os pesos iniciais mais learning_rate vezes
+      * soma_m alpha_m * (x_m, 1), onde alpha_m conta, com sinal, as atualizações causadas pela amostra m. Logo uma
+      * atualização com a amostra m muda a entrada líquida de cada amostra n em learning_rate * t * (K(m, n) + 1),
+      * onde K é a matriz de Gram (veja gram_matrix.h).
+      *
+      * Em vez dos pesos, são mantidas as somas inteiras D(i, n) = soma_m alpha_m * (K(m, n) + 1) de cada neurônio i
+      * e amostra n: avaliar um neurônio custa O(1) e cada atualização custa O(N), independentemente da dimensão.
+      * As épocas visitam as amostras e os neurônios na mesma ordem de 'internal_train' e os pesos só são
+      * reconstruídos ao final, a partir dos coeficientes alpha.
+      *
+      * @param dataset Os dados de treinamento: um vetor 2D de números inteiros, um PackedBipolarDataset ou um
+      *                SparseDataset.
+      * @param target A saída desejada para cada ponto de dados no dataset.
+      * @param options Os limites e o callback do treinamento (veja 'train').
+      * @return O motivo da parada e as estatísticas da última época.
+      */
+    template<typename Dataset, typename Target>
+    TrainResult internal_train_dual(const Dataset &dataset, const Target &target, const TrainOptions &options) {
+        const auto dim = static_cast<std::size_t>(dimension);
+        const auto classes = static_cast<std::size_t>(num_classes);
+        const std::size_t samples = dataset.size();
+        GramMatrix<Dataset> gram(dataset, dim);
+
+        // Entrada líquida de cada amostra com os pesos iniciais; D e alpha ficam agrupados por neurônio
+        std::vector<double> initial(classes * samples);
+        std::vector<std::int64_t> dual(classes * samples, 0);
+        std::vector<std::int64_t> alpha(classes * samples, 0);
+        // Perceptron médio: como em 'Averaging', cada atualização no passo 'step' soma t * step a beta
+        std::vector<std::int64_t> beta(options.average ? classes * samples : 0, 0);
+        std::int64_t step = 1;
+        for (std::size_t i = 0; i < classes; ++i) {
+            for (std::size_t n = 0; n < samples; ++n) {
+                initial[i * samples + n] = net_input(dataset[n], row(static_cast<int>(i)));
+            }
+        }
+
+        auto epoch = [&](CycleDetector *cycles, std::span<const std::size_t> order) {
+            EpochStats stats;
+            stats.evaluations = samples * classes;
+            for (std::size_t k = 0; k < samples; ++k) {
+                const std::size_t n = order.empty() ? k : order[k];
+                const auto &expected = target[n];
+                for (std::size_t i = 0; i < classes; ++i) {
+                    const int t = expected[i];
+                    const int output = activation(initial[i * samples + n] +
+                                                  learning_rate * static_cast<double>(dual[i * samples + n]));
+
+                    // Mesma condição de 'ch_weights'
+                    if (output != t && learning_rate != 0 && t != 0) {
+                        alpha[i * samples + n] += t;
+                        if (options.average) {
+                            beta[i * samples + n] += t * step;
+                        }
+                        const std::span<const std::int64_t> products = gram.row(n);
+                        std::int64_t *d = dual.data() + i * samples;
+                        for (std::size_t m = 0; m < samples; ++m) {
+                            d[m] += t * (products[m] + 1);
+                        }
+                        ++stats.updates;
+                        if (cycles != nullptr) {
+                            cycles->record_update(i, n, t);
+                        }
+                    }
+                    stats.misclassifications += output != t;
+                }
+                ++step;
+            }
+            return stats;
+        };
+        const TrainResult result = run_epochs(dataset, dim, classes, options, epoch);
+
+        // Reconstrói os pesos: soma exatamente os pontos de dados com os seus coeficientes e multiplica uma vez
+        std::vector<std::int64_t> sum(dim + 1);
+        auto combine = [&](const std::vector<std::int64_t> &coefficients, std::size_t i) {
+            std::fill(sum.begin(), sum.end(), 0);
+            for (std::size_t m = 0; m < samples; ++m) {
+                if (const std::int64_t a = coefficients[i * samples + m]; a != 0) {
+                    gram_detail::accumulate(dataset[m], a, sum.data(), dim);
+                    sum[dim] += a;
+                }
+            }
+        };
+        for (std::size_t i = 0; i < classes; ++i) {
+            double *weight = row(static_cast<int>(i));
+            combine(alpha, i);
+            for (std::size_t j = 0; j <= dim; ++j) {
+                weight[j] += learning_rate * static_cast<double>(sum[j]);
+            }
+            if (options.average) {
+                combine(beta, i);
+                for (std::size_t j = 0; j <= dim; ++j) {
+                    weight[j] -= learning_rate * static_cast<double>(sum[j]) / static_cast<double>(step);
+                }
+            }
+        }
+        refresh_bitplanes();
+        return result;
+    }
+
+    /**
+      * Treina o modelo dividindo as amostras entre várias threads, com mistura iterativa de parâmetros.
+      *
+      * Cada época começa com cada thread copiando os pesos do modelo e executando uma época local de
+      * 'internal_train_range' sobre o seu bloco contíguo de posições da época. Ao fim da época os pesos do modelo
+      * passam a ser a média das cópias locais ponderada pelo número de atualizações de cada thread; uma cópia sem
+      * atualizações não entra na média. Se nenhuma thread errou, os pesos do modelo classificam todas as amostras
+      * corretamente, então a convergência tem o mesmo significado que em 'train'.
+      *
+      * A divisão das amostras depende só do número de threads, então o resultado é determinístico para um mesmo
+      * número de threads; com uma única thread é idêntico ao de 'train'.
+      *
+      * @param dataset Os dados de treinamento (veja 'internal_train').
+      * @param target A saída desejada para cada ponto de dados no dataset (veja 'internal_train').
+      * @param num_threads O número de threads, incluindo a thread que chama a função.
+      * @param options Os limites e o callback do treinamento (veja 'train'); a detecção de ciclos e o perceptron
+      *                médio não são suportados, pois os pesos misturados não são uma soma de pontos de dados.
+      * @return O motivo da parada e as estatísticas da última época, somadas entre as threads.
+      */
+    template<typename Dataset, typename Target>
+    TrainResult internal_train_data_parallel(const Dataset &dataset, const Target &target, unsigned num_threads,
+                                             const TrainOptions &options) {
+        if (options.detect_cycles || options.average) {
+            throw std::invalid_argument("train_data_parallel: detect_cycles e average nao sao suportados");
+        }
+        const std::size_t samples = dataset.size();
+        const std::size_t shards = std::clamp<std::size_t>(num_threads, 1, std::max<std::size_t>(samples, 1));
+        const std::size_t matrix_size = static_cast<std::size_t>(num_classes) * stride;
+
+        // Cópias locais dos pesos, uma por thread, cada uma alinhada a uma linha de cache
+        std::vector<WeightMatrix> local;
+        local.reserve(shards);
+        for (std::size_t s = 0; s < shards; ++s) {
+            local.emplace_back(matrix_size);
+        }
+        std::vector<EpochStats> shard_stats(shards);
+
+        auto epoch = [&](CycleDetector *, std::span<const std::size_t> order) {
+            auto worker = [&](std::size_t s) {
+                std::copy(weights.data(), weights.data() + matrix_size, local[s].data());
+                shard_stats[s] = internal_train_range(dataset, target, samples * s / shards,
+                                                      samples * (s + 1) / shards, local[s].data(), nullptr, order);
+            };
+            {
+                std::vector<std::jthread> pool;
+                pool.reserve(shards - 1);
+                for (std::size_t s = 1; s < shards; ++s) {
+                    pool.emplace_back(worker, s);
+                }
+                worker(0);
+            }
+
+            EpochStats stats;
+            for (const EpochStats &shard: shard_stats) {
+                stats.misclassifications += shard.misclassifications;
+                stats.updates += shard.updates;
+                stats.evaluations += shard.evaluations;
+            }
+
+            // Mistura ponderada pelo número de atualizações de cada thread
+            if (stats.updates != 0) {
+                double *mixed = weights.data();
+                std::fill(mixed, mixed + matrix_size, 0.0);
+                for (std::size_t s = 0; s < shards; ++s) {
+                    if (shard_stats[s].updates == 0) {
+                        continue;
+                    }
+                    const double mu = static_cast<double>(shard_stats[s].updates) / static_cast<double>(stats.updates);
+                    const double *copy = local[s].data();
+                    for (std::size_t k = 0; k < matrix_size; ++k) {
+                        mixed[k] += mu * copy[k];
+                    }
+                }
+            }
+            return stats;
+        };
+
+        const TrainResult result = run_epochs(dataset, static_cast<std::size_t>(dimension),
+                                              static_cast<std::size_t>(num_classes), options, epoch);
+        refresh_bitplanes();
+        return result;
+    }
+
+    /**
+      * Executa uma época de treinamento de um único neurônio.
+      * Cada neurônio só lê e escreve a sua própria linha da matriz de pesos e a sua coluna do alvo, então o
+      * treinamento de neurônios diferentes é independente.
+      *
+      * @param dataset Os dados de treinamento (veja 'internal_train').
+      * @param target A saída desejada para cada ponto de dados no dataset (veja 'internal_train').
+      * @param i O índice do neurônio.
+      * @param order A ordem em que as amostras são visitadas; vazia visita na ordem do dataset.
+      * @return As estatísticas da época, contando só o neurônio i.
+      */
+    template<typename Dataset, typename Target>
+    EpochStats internal_train_class(const Dataset &dataset, const Target &target, int i,
+                                    std::span<const std::size_t> order = {}) {
+        EpochStats stats;
+        stats.evaluations = dataset.size();
+        double *weight = row(i);
+        for (std::size_t k = 0; k < dataset.size(); ++k) {
+            const std::size_t n = order.empty() ? k : order[k];
+            const auto &data = dataset[n];
+            const int expected = target[n][i];
+            int output = act_func(data, weight);
+            stats.updates += ch_weights(data, expected, output, weight);
+            stats.misclassifications += output != expected;
+        }
+        return stats;
+    }
+
+    /**
+      * Treina os neurônios em paralelo. Cada thread pega o próximo neurônio ainda não treinado e executa
+      * as suas épocas com o mesmo laço de 'train' (veja 'run_epochs'), até que ele convirja ou que um dos limites de
+      * 'options' seja atingido.
+      *
+      * Os limites valem para cada neurônio separadamente: 'max_epochs' e 'target_error_rate' contam as épocas e a
+      * taxa de erro de cada neurônio, e o prazo é verificado ao fim de cada uma das suas épocas. Como um neurônio que
+      * convergiu não é mais alterado pelas épocas seguintes, quando todos convergem o resultado é idêntico ao de
+      * 'train', inclusive com 'shuffle', já que a época k de cada neurônio usa a mesma ordem da época k de 'train'.
+      * As linhas da matriz de pesos começam em linhas de cache distintas, então as threads não disputam a mesma linha
+      * de cache.
+      *
+      * @param dataset Os dados de treinamento (veja 'internal_train').
+      * @param target A saída desejada para cada ponto de dados no dataset (veja 'internal_train').
+      * @param num_threads O número de threads, incluindo a thread que chama a função.
+      * @param options Os limites e o callback do treinamento (veja 'train'); 'on_epoch' recebe as estatísticas de um
+      *                único neurônio e pode ser chamado por várias threads ao mesmo tempo. A detecção de ciclos e o
+      *                perceptron médio não são suportados.
+      * @return O motivo da parada e as estatísticas da última época de cada neurônio, na ordem dos neurônios.
+      */
+    template<typename Dataset, typename Target>
+    std::vector<TrainResult> internal_train_parallel(const Dataset &dataset, const Target &target,
+                                                     unsigned num_threads, const TrainOptions &options) {
+        if (options.detect_cycles || options.average) {
+            throw std::invalid_argument("train_parallel: detect_cycles e average nao sao suportados");
+        }
+        std::vector<TrainResult> results(static_cast<std::size_t>(num_classes));
+        std::atomic<int> next_class{0};
+        auto worker = [&] {
+            for (int i = next_class++; i < num_classes; i = next_class++) {
+                results[static_cast<std::size_t>(i)] =
+                        run_epochs(dataset, static_cast<std::size_t>(dimension), 1, options,
+                                   [&](CycleDetector *, std::span<const std::size_t> order) {
+                                       return internal_train_class(dataset, target, i, order);
+                                   });
+            }
+        };
+
+        const unsigned workers = std::clamp(num_threads, 1u, static_cast<unsigned>(std::max(num_classes, 1)));
+        {
+            std::vector<std::jthread> pool;
+            pool.reserve(workers - 1);
+            for (unsigned t = 1; t < workers; ++t) {
+                pool.emplace_back(worker);
+            }
+            worker();
+        }
+        refresh_bitplanes();
+        return results;
+    }
+
+    /**
+      * Arredonda o tamanho de uma linha (pesos mais bias) para um múltiplo da linha de cache.
+      *
+      * @param dimension A dimensão dos dados de entrada.
+      * @return A distância, em números decimais, entre o início de duas linhas da matriz de pesos.
+      */
+    static std::size_t row_stride(int dimension) {
+        constexpr std::size_t per_line = cache_line / sizeof(double);
+        return (static_cast<std::size_t>(dimension) + 1 + per_line - 1) / per_line * per_line;
+    }
+
+    /**
+      * Verifica se um conjunto tem a forma do modelo (veja 'check_training_shape').
+      *
+      * @param dataset O conjunto rotulado.
+      * @param caller O nome da função que faz a verificação, usado na mensagem de erro.
+      */
+    template<LabeledData Data>
+    void check_shape(const Data &dataset, const std::string &caller) const {
+        check_training_shape(dataset, static_cast<std::size_t>(dimension), static_cast<std::size_t>(num_classes),
+                             caller);
+    }
+
+    /**
+      * Versão de 'check_shape' para pontos de dados e saídas desejadas separados.
+      */
+    template<TrainingData Data, TrainingTarget Target>
+    void check_shape(const Data &dataset, const Target &target, const std::string &caller) const {
+        check_training_shape(dataset, target, static_cast<std::size_t>(dimension),
+                             static_cast<std::size_t>(num_classes), caller);
+    }
+
+    /**
+      * Verifica se um ponto de dados bipolar empacotado tem o número de palavras da dimensão do modelo.
+      */
+    void check_input(BipolarSample data) const {
+        if (data.words.size() != (static_cast<std::size_t>(dimension) + 63) / 64) {
+            throw std::invalid_argument("predict: a dimensao da entrada difere da do modelo");
+        }
+    }
+
+    /**
+      * Verifica se todos os índices de um ponto de dados esparso estão dentro da dimensão do modelo. Todos os
+      * índices são verificados, então eles não precisam estar ordenados; o custo é o mesmo da predição.
+      */
+    void check_input(SparseSample data) const {
+        if (data.values.size() != data.nnz()) {
+            throw std::invalid_argument("predict: a entrada esparsa tem numeros diferentes de indices e valores");
+        }
+        if (std::any_of(data.indices.begin(), data.indices.end(),
+                        [&](std::uint32_t j) { return j >= static_cast<std::uint32_t>(dimension); })) {
+            throw std::invalid_argument("predict: indice da entrada esparsa fora da dimensao do modelo");
+        }
+    }
+
+    /**
+      * Calcula as saídas de todos os neurônios para um ponto de dados bipolar empacotado (veja 'predict').
+      *
+      * @param data Um ponto de dados bipolar empacotado.
+      * @param output Ponteiro para as 'num_classes' saídas.
+      * @param net Se não for nulo, ponteiro para as 'num_classes' entradas líquidas.
+      */
+    void predict_into(BipolarSample data, int *output, double *net = nullptr) const {
+        const BitplaneWeights &planes = bitplanes.get(weights.data(), stride,
+                                                      static_cast<std::size_t>(dimension),
+                                                      static_cast<std::size_t>(num_classes));
+        for (int i = 0; i < num_classes; ++i) {
+            const double value = planes.valid()
+                                 ? static_cast<double>(planes.net(static_cast<std::size_t>(i), data))
+                                 : net_input(data, row(i));
+            output[i] = activation(value);
+            if (net != nullptr) {
+                net[i] = value;
+            }
+        }
+    }
+
+    /**
+      * Calcula as saídas e, opcionalmente, as entradas líquidas de todos os neurônios nos buffers do chamador.
+      */
+    template<typename Sample>
+    void predict_into(Sample data, std::span<int> output, std::span<double> net) const {
+        if (output.size() != static_cast<std::size_t>(num_classes) ||
+            (!net.empty() && net.size() != static_cast<std::size_t>(num_classes))) {
+            throw std::invalid_argument("predict: a saida deve ter num_classes elementos");
+        }
+        for (int i = 0; i < num_classes; ++i) {
+            const double value = net_input(data, row(i));
+            output[i] = activation(value);
+            if (!net.empty()) {
+                net[i] = value;
+            }
+        }
+    }
+
+    /**
+      * Descarta os planos de bits dos pesos usados na predição de entradas bipolares empacotadas, que são
+      * reconstruídos na próxima predição bipolar. Deve ser chamado sempre que os pesos mudam.
+      */
+    void refresh_bitplanes() {
+        bitplanes.reset();
+    }
+
+    [[nodiscard]] double *row(int i) { return weights.data() + static_cast<std::size_t>(i) * stride; }
+
+    [[nodiscard]] const double *row(int i) const { return weights.data() + static_cast<std::size_t>(i) * stride; }
+
+    /**
+      * Cria um modelo a partir de uma matriz de pesos já preenchida (usado por 'load').
+      */
+    SingleLayerPerceptron(int dimension, int num_classes, double learning_rate, double theta, WeightMatrix &&weights)
+            : dimension(dimension), num_classes(num_classes), stride(row_stride(dimension)),
+              weights(std::move(weights)), learning_rate(learning_rate), theta(theta) {}
+
+public:
+    SingleLayerPerceptron(int dimension, int num_classes, double learning_rate, double theta)
+            : dimension(dimension), num_classes(num_classes), stride(row_stride(dimension)),
+              weights(static_cast<std::size_t>(num_classes) * stride),
+              learning_rate(learning_rate), theta(theta) {}
+
+    [[nodiscard]] int input_dimension() const { return dimension; }
+
+    [[nodiscard]] int class_count() const { return num_classes; }
+
+    /**
+      * Salva o modelo (dimensão, número de classes, taxa de aprendizado, theta e a matriz de pesos com os bias)
+      * no formato binário de checkpoint.h. O arquivo é gravado com outro nome e renomeado (veja 'writeCheckpoint'),
+      * então pode ser o mesmo de que o modelo foi carregado, ou de que outro processo carregou um modelo.
+      *
+      * @param filename O caminho do arquivo.
+      * @throws std::runtime_error se o arquivo não puder ser gravado.
+      */
+    void save(const std::string &filename) const {
+        CheckpointHeader header{};
+        header.dimension = static_cast<std::uint64_t>(dimension);
+        header.num_classes = static_cast<std::uint64_t>(num_classes);
+        header.stride = stride;
+        header.learning_rate = learning_rate;
+        header.theta = theta;
+        writeCheckpoint(filename, header, weights.data());
+    }
+
+    /**
+      * Carrega um modelo salvo por 'save'.
+      * O arquivo é mapeado em memória e os pesos são usados diretamente das suas páginas, sem cópia nem leitura (os
+      * planos de bits das predições bipolares só são construídos na primeira delas): a carga não depende do
+      * tamanho do modelo e processos que carregam o mesmo arquivo compartilham as páginas. Se o modelo
+      * for treinado novamente, as páginas alteradas passam a ser privadas do processo e as alterações nunca chegam
+      * ao arquivo. Como 'save' troca o arquivo por um novo em vez de regravá-lo, salvar um modelo no mesmo caminho
+      * não altera o modelo carregado; um programa que escreva diretamente no arquivo, sem trocá-lo, pode alterar os
+      * pesos do modelo carregado ou, se o truncar, fazer com que a leitura dos pesos termine o processo (SIGBUS).
+      *
+      * @param filename O caminho do arquivo.
+      * @return O modelo carregado.
+      * @throws std::runtime_error se o arquivo não puder ser lido ou não estiver no formato esperado.
+      */
+    static SingleLayerPerceptron load(const std::string &filename) {
+        MappedFile file(filename, MappedFile::Access::copy_on_write);
+        const CheckpointHeader header = readCheckpointHeader(file, filename);
+        if (header.dimension > static_cast<std::uint64_t>(std::numeric_limits<int>::max()) ||
+            header.num_classes > static_cast<std::uint64_t>(std::numeric_limits<int>::max()) ||
+            header.stride != row_stride(static_cast<int>(header.dimension))) {
+            throw std::runtime_error("load: dimensoes invalidas em " + filename);
+        }
+        WeightMatrix weights(std::move(file), header.weights_offset, header.num_classes * header.stride);
+        return {static_cast<int>(header.dimension), static_cast<int>(header.num_classes), header.learning_rate,
+                header.theta, std::move(weights)};
+    }
+
+    /**
+      * Treina o modelo até que os pesos não sejam mais alterados ou que um dos limites de 'options' seja atingido.
+      *
+      * Os pontos de dados podem ser um vetor 2D de números inteiros, um PackedBipolarDataset ou um SparseDataset, e
+      * as saídas desejadas um vetor 2D ou uma MatrixView<int> (por exemplo 'Dataset::label_view'), em qualquer
+      * combinação. Os conjuntos empacotado e esparso produzem exatamente os mesmos pesos que o conjunto denso, com
+      * custo por época proporcional ao número de palavras ou de valores não nulos.
+      *
+      * @param dataset Os pontos de dados.
+      * @param target A saída desejada para cada ponto de dados no dataset.
+      * @param options Número máximo de épocas, prazo, taxa de erro desejada e callback por época; por padrão,
+      *                treina até convergir.
+      * @return O motivo da parada e as estatísticas da última época.
+      * @throws std::invalid_argument se a forma dos dados ou das saídas desejadas diferir da do modelo.
+      */
+    template<TrainingData Data = std::vector<std::vector<int>>,
+             TrainingTarget Target = std::vector<std::vector<int>>>
+    TrainResult train(const Data &dataset, const Target &target, const TrainOptions &options = {}) {
+        check_shape(dataset, target, "train");
+        return internal_train_until(dataset, target, options);
+    }
+
+    /**
+      * Treina o modelo com um conjunto que guarda as saídas desejadas: um Dataset (veja dataset.h), cujas linhas são
+      * usadas diretamente, ou um BinaryDataset, cujos blocos são lidos diretamente do arquivo mapeado, sem cópia.
+      * Produz exatamente os mesmos pesos que o treinamento com vetores 2D.
+      *
+      * @param dataset Os pontos de dados e as saídas desejadas, por exemplo lidos por 'readData'.
+      * @param options Os limites e o callback do treinamento (veja 'train').
+      * @return O motivo da parada e as estatísticas da última época.
+      */
+    template<LabeledData Data>
+    TrainResult train(const Data &dataset, const TrainOptions &options = {}) {
+        check_shape(dataset, "train");
+        return with_labels(dataset, [&](const auto &data, const auto &target) {
+            return internal_train_until(data, target, options);
+        });
+    }
+
+    /**
+      * Treina o modelo na forma dual (veja 'internal_train_dual'), com a matriz de Gram das amostras em vez dos pesos.
+      * Cada atualização custa O(N) em vez de O(dimension), o que compensa quando há poucas amostras de dimensão
+      * muito grande; a memória cresce com N^2. As épocas e o motivo da parada são os mesmos de 'train'.
+      * As somas das entradas líquidas são exatas, então, com taxa de aprendizado inteira e pesos iniciais inteiros
+      * (como os de um modelo novo), os pesos finais são idênticos aos de 'train'; com outras taxas podem diferir
+      * pelos erros de arredondamento que 'train' acumula a cada atualização. Com o conjunto empacotado, K(m, n) é
+      * calculado com XOR e popcount.
+      *
+      * @param dataset Os pontos de dados (veja 'train').
+      * @param target A saída desejada para cada ponto de dados no dataset (veja 'train').
+      * @param options Os limites e o callback do treinamento (veja 'train').
+      * @return O motivo da parada e as estatísticas da última época.
+      */
+    template<TrainingData Data = std::vector<std::vector<int>>,
+             TrainingTarget Target = std::vector<std::vector<int>>>
+    TrainResult train_dual(const Data &dataset, const Target &target, const TrainOptions &options = {}) {
+        check_shape(dataset, target, "train_dual");
+        return internal_train_dual(dataset, target, options);
+    }
+
+    /**
+      * Versão de 'train_dual' para um conjunto que guarda as saídas desejadas (veja 'train').
+      */
+    template<LabeledData Data>
+    TrainResult train_dual(const Data &dataset, const TrainOptions &options = {}) {
+        check_shape(dataset, "train_dual");
+        return with_labels(dataset, [&](const auto &data, const auto &target) {
+            return internal_train_dual(data, target, options);
+        });
+    }
+
+    /**
+      * Treina o modelo distribuindo os neurônios entre várias threads.
+      * Quando todos os neurônios convergem, produz exatamente os mesmos pesos que 'train'.
+      *
+      * @param dataset Os pontos de dados (veja 'train').
+      * @param target A saída desejada para cada ponto de dados no dataset (veja 'train').
+      * @param num_threads O número de threads; por padrão, o número de núcleos do processador.
+      * @param options Os limites e o callback do treinamento (veja 'train'), exceto 'detect_cycles' e 'average'.
+      *                Os limites valem para cada neurônio separadamente; por padrão, treina cada um até convergir.
+      * @return O motivo da parada e as estatísticas da última época de cada neurônio (veja 'internal_train_parallel').
+      */
+    template<TrainingData Data = std::vector<std::vector<int>>,
+             TrainingTarget Target = std::vector<std::vector<int>>>
+    std::vector<TrainResult> train_parallel(const Data &dataset, const Target &target,
+                                            unsigned num_threads = std::thread::hardware_concurrency(),
+                                            const TrainOptions &options = {}) {
+        check_shape(dataset, target, "train_parallel");
+        return internal_train_parallel(dataset, target, num_threads, options);
+    }
+
+    /**
+      * Versão de 'train_parallel' para um conjunto que guarda as saídas desejadas (veja 'train').
+      */
+    template<LabeledData Data>
+    std::vector<TrainResult> train_parallel(const Data &dataset,
+                                            unsigned num_threads = std::thread::hardware_concurrency(),
+                                            const TrainOptions &options = {}) {
+        check_shape(dataset, "train_parallel");
+        return with_labels(dataset, [&](const auto &data, const auto &target) {
+            return internal_train_parallel(data, target, num_threads, options);
+        });
+    }
+
+    /**
+      * Treina o modelo dividindo as amostras entre várias threads (veja 'internal_train_data_parallel').
+      * Ao contrário de 'train_parallel', que divide os neurônios, também acelera modelos com poucas classes;
+      * cada época custa O(N / num_threads) por thread mais a mistura dos pesos, O(num_threads x num_classes x
+      * dimension). Os pesos finais diferem dos de 'train', mas o modelo converge para um conjunto linearmente
+      * separável.
+      *
+      * @param dataset Os pontos de dados (veja 'train').
+      * @param target A saída desejada para cada ponto de dados no dataset (veja 'train').
+      * @param num_threads O número de threads, incluindo a thread que chama a função.
+      * @param options Os limites e o callback do treinamento (veja 'train'), exceto 'detect_cycles' e 'average'.
+      * @return O motivo da parada e as estatísticas da última época.
+      */
+    template<TrainingData Data = std::vector<std::vector<int>>,
+             TrainingTarget Target = std::vector<std::vector<int>>>
+    TrainResult train_data_parallel(const Data &dataset, const Target &target,
+                                    unsigned num_threads = std::thread::hardware_concurrency(),
+                                    const TrainOptions &options = {}) {
+        check_shape(dataset, target, "train_data_parallel");
+        return internal_train_data_parallel(dataset, target, num_threads, options);
+    }
+
+    /**
+      * Versão de 'train_data_parallel' para um conjunto que guarda as saídas desejadas (veja 'train').
+      */
+    template<LabeledData Data>
+    TrainResult train_data_parallel(const Data &dataset, unsigned num_threads = std::thread::hardware_concurrency(),
+                                    const TrainOptions &options = {}) {
+        check_shape(dataset, "train_data_parallel");
+        return with_labels(dataset, [&](const auto &data, const auto &target) {
+            return internal_train_data_parallel(data, target, num_threads, options);
+        });
+    }
+
+    /**
+      * Faz uma previsão para um ponto de dados.
+      *
+      * @param data Um ponto de dados: um vetor de inteiros ou uma linha de um Dataset.
+      * @return As saídas da função de ativação de cada neurônio.
+      */
+    std::vector<int> predict(std::span<const int> data) const {
+        std::vector<int> output(num_classes);
+        for (int i = 0; i < num_classes; ++i) {
+            output[i] = act_func(data, row(i));
+        }
+        return output;
+    }
+
+    /**
+      * Versão de 'predict' que não aloca memória: escreve as saídas em um buffer do chamador, que pode ser
+      * reaproveitado entre as chamadas. O resultado é o mesmo de 'predict'.
+      *
+      * @param data Um ponto de dados com 'dimension' valores.
+      * @param output Recebe as saídas da função de ativação dos 'num_classes' neurônios.
+      * @param net Se não for vazio, recebe as 'num_classes' entradas líquidas, antes da função de ativação; a
+      *            distância de cada uma até theta indica a confiança da saída.
+      * @throws std::invalid_argument se o tamanho da entrada ou dos buffers for diferente do modelo.
+      */
+    void predict(std::span<const int> data, std::span<int> output, std::span<double> net = {}) const {
+        if (data.size() != static_cast<std::size_t>(dimension)) {
+            throw std::invalid_argument("predict: a dimensao da entrada difere da do modelo");
+        }
+        predict_into(data, output, net);
+    }
+
+    /**
+      * Faz uma previsão para um ponto de dados bipolar empacotado.
+      * Se todos os pesos forem inteiros, o produto escalar é calculado com XOR e popcount sobre os planos de bits
+      * dos pesos; caso contrário, usa o kernel bipolar sobre os pesos decimais. O resultado é o mesmo de 'predict'.
+      *
+      * @param data Um ponto de dados bipolar empacotado.
+      * @return As saídas da função de ativação de cada neurônio.
+      * @throws std::invalid_argument se o número de palavras do ponto de dados não corresponder à dimensão.
+      */
+    std::vector<int> predict(BipolarSample data) const {
+        check_input(data);
+        std::vector<int> output(num_classes);
+        predict_into(data, output.data());
+        return output;
+    }
+
+    /**
+      * Versão de 'predict' sem alocações para um ponto de dados bipolar empacotado (veja 'predict' com spans).
+      * Com os planos de bits, as entradas líquidas são as mesmas, já que os pesos são inteiros.
+      */
+    void predict(BipolarSample data, std::span<int> output, std::span<double> net = {}) const {
+        check_input(data);
+        if (output.size() != static_cast<std::size_t>(num_classes) ||
+            (!net.empty() && net.size() != static_cast<std::size_t>(num_classes))) {
+            throw std::invalid_argument("predict: a saida deve ter num_classes elementos");
+        }
+        predict_into(data, output.data(), net.empty() ? nullptr : net.data());
+    }
+
+    /**
+      * Faz uma previsão para um ponto de dados esparso, com custo proporcional ao número de valores não nulos.
+      * O resultado é o mesmo de 'predict' com o ponto de dados denso.
+      *
+      * @param data Um ponto de dados esparso.
+      * @return As saídas da função de ativação de cada neurônio.
+      * @throws std::invalid_argument se algum índice estiver fora da dimensão do modelo.
+      */
+    std::vector<int> predict(SparseSample data) const {
+        check_input(data);
+        std::vector<int> output(num_classes);
+        for (int i = 0; i < num_classes; ++i) {
+            output[i] = act_func(data, row(i));
+        }
+        return output;
+    }
+
+    /**
+      * Versão de 'predict' sem alocações para um ponto de dados esparso (veja 'predict' com spans).
+      */
+    void predict(SparseSample data, std::span<int> output, std::span<double> net = {}) const {
+        check_input(data);
+        predict_into(data, output, net);
+    }
+
+    /**
+      * Faz a previsão de um lote de N pontos de dados de uma só vez.
+      * As amostras são processadas em blocos de 'batch_tile_rows' linhas e 'batch_tile_cols' colunas:
+      * cada bloco da entrada é reaproveitado por todas as linhas da matriz de pesos enquanto ainda está na cache,
+      * e cada peso carregado é multiplicado por todas as amostras do bloco.
+      * As entradas líquidas são acumuladas na mesma ordem de 'act_func', logo o resultado é idêntico ao de 'predict'.
+      *
+      * @param data Matriz N x dimension, linha a linha, com os pontos de dados.
+      * @param output Matriz N x num_classes, linha a linha, que recebe as saídas da função de ativação.
+      */
+    void predict_batch(std::span<const int> data, std::span<int> output) const {
+        const auto dim = static_cast<std::size_t>(dimension);
+        const auto classes = static_cast<std::size_t>(num_classes);
+        if (dim == 0 || data.size() % dim != 0) {
+            throw std::invalid_argument("predict_batch: o tamanho da entrada nao e multiplo da dimensao");
+        }
+        const std::size_t rows = data.size() / dim;
+        if (output.size() != rows * classes) {
+            throw std::invalid_argument("predict_batch: a saida deve ter N x num_classes elementos");
+        }
+
+        const kernels::KernelTable &kernel = kernels::active();
+
+        // Somas parciais do produto escalar do bloco de amostras atual; as 'batch_tile_rows' amostras de
+        // um mesmo neurônio ficam lado a lado, como espera 'kernels::dot4'
+        std::vector<double> partial(classes * batch_tile_rows * kernels::lanes);
+
+        for (std::size_t first = 0; first < rows; first += batch_tile_rows) {
+            const std::size_t tile = std::min(batch_tile_rows, rows - first);
+            const int *x = data.data() + first * dim;
+            std::fill(partial.begin(), partial.end(), 0.0);
+
+            // Percorre a dimensão em blocos, aplicando cada bloco da entrada a todos os neurônios
+            for (std::size_t col = 0; col < dim; col += batch_tile_cols) {
+                const std::size_t len = std::min(batch_tile_cols, dim - col);
+                for (std::size_t c = 0; c < classes; ++c) {
+                    const double *w = row(static_cast<int>(c)) + col;
+                    double *acc = partial.data() + c * batch_tile_rows * kernels::lanes;
+                    if (tile == batch_tile_rows) {
+                        kernel.dot4(x + col, dim, w, len, acc);
+                    } else {
+                        for (std::size_t s = 0; s < tile; ++s) {
+                            kernel.dot(x + s * dim + col, w, len, acc + s * kernels::lanes);
+                        }
+                    }
+                }
+            }
+
+            // Adiciona o bias e aplica a função de ativação às entradas líquidas do bloco
+            int *out = output.data() + first * classes;
+            for (std::size_t s = 0; s < tile; ++s) {
+                for (std::size_t c = 0; c < classes; ++c) {
+                    const double *acc = partial.data() + (c * batch_tile_rows + s) * kernels::lanes;
+                    out[s * classes + c] = activation(row(static_cast<int>(c))[dim] + kernels::reduce(acc));
+                }
+            }
+        }
+    }
+
+    /**
+      * Faz a previsão de um conjunto de pontos de dados usando 'predict_batch'.
+      *
+      * @param dataset Um vetor 2D de números inteiros com os pontos de dados.
+      * @return Um vetor 2D com as saídas da função de ativação para cada ponto de dados.
+      */
+    std::vector<std::vector<int>> predict_batch(const std::vector<std::vector<int>> &dataset) const {
+        const auto dim = static_cast<std::size_t>(dimension);
+        std::vector<int> data;
+        data.reserve(dataset.size() * dim);
+        for (const auto &sample: dataset) {
+            data.insert(data.end(), sample.begin(), sample.end());
+        }
+
+        std::vector<int> flat(dataset.size() * static_cast<std::size_t>(num_classes));
+        predict_batch(data, flat);
+
+        std::vector<std::vector<int>> output;
+        output.reserve(dataset.size());
+        for (auto it = flat.begin(); it != flat.end(); it += num_classes) {
+            output.emplace_back(it, it + num_classes);
+        }
+        return output;
+    }
+
+    /**
+      * Faz a previsão de todos os pontos de dados de um conjunto em buffers contíguos com 'predict_batch'.
+      *
+      * @param dataset O conjunto de dados.
+      * @return Matriz N x num_classes, linha a linha, com as saídas da função de ativação.
+      */
+    std::vector<int> predict_batch(const Dataset &dataset) const {
+        if (dataset.dimension() != static_cast<std::size_t>(dimension)) {
+            throw std::invalid_argument("predict_batch: a dimensao do conjunto difere da do modelo");
+        }
+        std::vector<int> output(dataset.size() * static_cast<std::size_t>(num_classes));
+        predict_batch(dataset.features, output);
+        return output;
+    }
+
+    /**
+      * Faz a previsão de todos os pontos de dados de um conjunto no formato binário.
+      *
+      * @param dataset O conjunto de dados binário.
+      * @return Matriz N x num_classes, linha a linha, com as saídas da função de ativação.
+      */
+    std::vector<int> predict_batch(const BinaryDataset &dataset) const {
+        if (dataset.dimension() != static_cast<std::size_t>(dimension)) {
+            throw std::invalid_argument("predict_batch: a dimensao do conjunto binario difere da do modelo");
+        }
+        const auto classes = static_cast<std::size_t>(num_classes);
+        std::vector<int> output(dataset.size() * classes);
+        if (dataset.is_bipolar()) {
+            const BipolarMatrixView samples = dataset.bipolar_features();
+            for (std::size_t n = 0; n < samples.size(); ++n) {
+                predict_into(samples[n], output.data() + n * classes);
+            }
+        } else {
+            predict_batch(dataset.features().values, output);
+        }
+        return output;
+    }
+
+    /**
+      * Faz a previsão de todos os pontos de dados de um conjunto esparso.
+      *
+      * @param dataset O conjunto de dados esparso.
+      * @return Matriz N x num_classes, linha a linha, com as saídas da função de ativação.
+      */
+    std::vector<int> predict_batch(const SparseDataset &dataset) const {
+        if (dataset.dimension() != static_cast<std::size_t>(dimension)) {
+            throw std::invalid_argument("predict_batch: a dimensao do conjunto esparso difere da do modelo");
+        }
+        const auto classes = static_cast<std::size_t>(num_classes);
+        std::vector<int> output(dataset.size() * classes);
+        for (std::size_t n = 0; n < dataset.size(); ++n) {
+            const SparseSample data = dataset[n];
+            for (std::size_t c = 0; c < classes; ++c) {
+                output[n * classes + c] = act_func(data, row(static_cast<int>(c)));
+            }
+        }
+        return output;
+    }
+
+    void print_weights() const {
+        for (int i = 0; i < num_classes; ++i) {
+            const double *weight = row(i);
+            std::cout << "Neuronio " << i + 1 << ":" << std::endl;
+            std::cout << "Peso: ";
+            std::copy(weight, weight + dimension, std::ostream_iterator<double>(std::cout, ", "));
+            std::cout << std::endl;
+            std::cout << "Peso do bias: " << weight[dimension] << std::endl;
+        }
+    }
+};
+
+#endif //SINGLELAYERPERCEPTRON_SINGLE_LAYER_PERCEPTRON_H
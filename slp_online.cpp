@@ -0,0 +1,140 @@
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <signal.h>
+
+#include "online_trainer.h"
+#include "single_layer_perceptron.h"
+
+namespace {
+
+std::atomic<bool> stop_requested{false};
+
+extern "C" void request_stop(int) {
+    stop_requested = true;
+}
+
+/**
+  * Instala 'request_stop' para SIGINT e SIGTERM sem SA_RESTART (que std::signal usa na glibc), para que uma leitura
+  * bloqueada da entrada padrão seja interrompida com EINTR e o treinamento termine sem esperar a próxima linha.
+  */
+void install_stop_handlers() {
+    struct sigaction action{};
+    action.sa_handler = request_stop;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = 0;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+}
+
+void print_usage(const char *program) {
+    std::cerr << "Uso: " << program << " <modelo> <dimensao> <classes> [--input arquivo] [--follow]"
+              << " [--learning-rate R] [--theta T] [--snapshot-every N] [--snapshot-seconds S]" << std::endl;
+}
+
+} // namespace
+
+/**
+  * Treinamento online: lê amostras no formato de 'readData' da entrada padrão (ou de um arquivo com --input) e
+  * treina o modelo com cada uma assim que ela chega, sem guardar o conjunto de dados (veja online_trainer.h).
+  * Se o arquivo do modelo existir, o treinamento continua a partir dele.
+  *
+  * Uso: slp_online <modelo> <dimensao> <classes> [--input arquivo] [--follow] [--learning-rate R] [--theta T]
+  *                 [--snapshot-every N] [--snapshot-seconds S]
+  *
+  * O modelo é salvo a cada N amostras e a cada S segundos, trocando o arquivo atomicamente, e ao fim da entrada.
+  * Com --follow, o arquivo de entrada é acompanhado enquanto cresce, como 'tail -f', até SIGINT ou SIGTERM.
+  * SIGINT e SIGTERM também interrompem a espera por uma linha da entrada padrão; o modelo é salvo antes de sair.
+  * Assim, 'slp_server' pode servir o mesmo arquivo e recarregá-lo com SIGHUP.
+  */
+int main(int argc, char *argv[]) {
+    if (argc < 4) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    OnlineOptions options;
+    options.snapshot_path = argv[1];
+    std::string input_path;
+    double learning_rate = 0.1;
+    double theta = 0.2;
+    int dimension = 0;
+    int num_classes = 0;
+    try {
+        dimension = std::stoi(argv[2]);
+        num_classes = std::stoi(argv[3]);
+        for (int k = 4; k < argc; ++k) {
+            const std::string arg = argv[k];
+            if (arg == "--follow") {
+                options.follow = true;
+                continue;
+            }
+            if (k + 1 >= argc) {
+                print_usage(argv[0]);
+                return 2;
+            }
+            const std::string value = argv[++k];
+            if (arg == "--input") {
+                input_path = value;
+            } else if (arg == "--learning-rate") {
+                learning_rate = std::stod(value);
+            } else if (arg == "--theta") {
+                theta = std::stod(value);
+            } else if (arg == "--snapshot-every") {
+                options.snapshot_every = std::stoull(value);
+            } else if (arg == "--snapshot-seconds") {
+                options.snapshot_interval = std::chrono::seconds(std::stoll(value));
+            } else {
+                print_usage(argv[0]);
+                return 2;
+            }
+        }
+    } catch (const std::exception &) {
+        print_usage(argv[0]);
+        return 2;
+    }
+    if (options.follow && input_path.empty()) {
+        std::cerr << "--follow precisa de --input" << std::endl;
+        return 2;
+    }
+
+    try {
+        SingleLayerPerceptron model = std::filesystem::exists(options.snapshot_path)
+                                      ? SingleLayerPerceptron::load(options.snapshot_path)
+                                      : SingleLayerPerceptron(dimension, num_classes, learning_rate, theta);
+        if (model.input_dimension() != dimension || model.class_count() != num_classes) {
+            std::cerr << options.snapshot_path << ": o formato do modelo salvo difere de " << dimension << "x"
+                      << num_classes << std::endl;
+            return 1;
+        }
+
+        std::ifstream file;
+        if (!input_path.empty()) {
+            file.open(input_path);
+            if (!file) {
+                std::cerr << "nao foi possivel abrir " << input_path << std::endl;
+                return 1;
+            }
+        }
+
+        install_stop_handlers();
+        options.stop = &stop_requested;
+
+        OnlineTrainer trainer(model);
+        const OnlineStats stats = trainer.train(input_path.empty() ? std::cin : file, options);
+        std::cout << stats.samples << " amostras, " << stats.misclassifications << " saidas erradas, "
+                  << stats.updates << " atualizacoes, " << stats.skipped << " linhas ignoradas" << std::endl;
+        if (stats.skipped != 0) {
+            std::cerr << "linha " << stats.last_error.line << ": " << stats.last_error.message << std::endl;
+        }
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
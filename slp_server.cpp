@@ -0,0 +1,110 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <csignal>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "inference_server.h"
+#include "model_handle.h"
+#include "single_layer_perceptron.h"
+
+namespace {
+
+std::atomic<bool> stop_requested{false};
+std::atomic<bool> reload_requested{false};
+
+extern "C" void request_stop(int) {
+    stop_requested = true;
+}
+
+extern "C" void request_reload(int) {
+    reload_requested = true;
+}
+
+void print_usage(const char *program) {
+    std::cerr << "Uso: " << program << " <modelo> <socket> [--max-batch N] [--max-wait-us U] [--max-request N]"
+              << std::endl;
+}
+
+} // namespace
+
+/**
+  * Servidor de inferência: carrega um modelo salvo por 'SingleLayerPerceptron::save' e atende pedidos de predição
+  * por um socket UNIX (veja inference_server.h), agrupando pedidos simultâneos em lotes.
+  *
+  * Uso: slp_server <modelo> <socket> [--max-batch N] [--max-wait-us U] [--max-request N]
+  *
+  * Com SIGHUP, carrega o arquivo do modelo de novo e passa a usá-lo sem interromper os pedidos, por exemplo
+  * depois que um novo treinamento salvou outro modelo no mesmo caminho. O modelo em uso fica mapeado em memória,
+  * então o arquivo deve ser trocado, como faz 'save' (um arquivo novo renomeado para o caminho), e nunca regravado
+  * no lugar: regravá-lo alteraria o modelo em uso e, se o arquivo ficasse menor, terminaria o servidor com SIGBUS.
+  * Para com SIGINT ou SIGTERM, depois de responder os pedidos já recebidos.
+  */
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    InferenceServerOptions options;
+    try {
+        for (int k = 3; k < argc; k += 2) {
+            const std::string arg = argv[k];
+            if (k + 1 >= argc) {
+                print_usage(argv[0]);
+                return 2;
+            }
+            const std::string value = argv[k + 1];
+            if (arg == "--max-batch") {
+                options.max_batch = std::stoull(value);
+            } else if (arg == "--max-wait-us") {
+                options.max_wait = std::chrono::microseconds(std::stoll(value));
+            } else if (arg == "--max-request") {
+                options.max_request = std::stoull(value);
+            } else {
+                print_usage(argv[0]);
+                return 2;
+            }
+        }
+    } catch (const std::exception &) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    try {
+        const std::string filename = argv[1];
+        ModelHandle handle(SingleLayerPerceptron::load(filename));
+        InferenceServer server(handle, argv[2], options);
+
+        std::signal(SIGINT, request_stop);
+        std::signal(SIGTERM, request_stop);
+        std::signal(SIGHUP, request_reload);
+        std::signal(SIGPIPE, SIG_IGN);
+        std::cout << "Modelo " << filename << " (dimensao " << handle.input_dimension() << ", "
+                  << handle.class_count() << " classes) em " << argv[2] << std::endl;
+
+        // Recarrega o modelo fora das threads do servidor; os lotes seguintes usam a nova versão
+        std::jthread reloader([&] {
+            while (!stop_requested.load()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                if (!reload_requested.exchange(false)) {
+                    continue;
+                }
+                try {
+                    const std::uint64_t version = handle.publish(SingleLayerPerceptron::load(filename));
+                    std::cout << "Modelo recarregado (versao " << version << ")" << std::endl;
+                } catch (const std::exception &e) {
+                    std::cerr << "Falha ao recarregar o modelo: " << e.what() << std::endl;
+                }
+            }
+        });
+        server.run(stop_requested);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
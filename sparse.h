@@ -0,0 +1,148 @@
+#ifndef SINGLELAYERPERCEPTRON_SPARSE_H
+#define SINGLELAYERPERCEPTRON_SPARSE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+/**
+  * Ponto de dados esparso: os índices (em ordem crescente e sem repetição) e os valores dos elementos não nulos.
+  * Os elementos ausentes valem 0.
+  */
+struct SparseSample {
+    std::span<const std::uint32_t> indices;
+    std::span<const int> values;
+
+    [[nodiscard]] std::size_t nnz() const { return indices.size(); }
+};
+
+/**
+  * Conjunto de dados esparso no formato CSR (compressed sparse row): os índices e os valores não nulos de todas as
+  * amostras ficam em dois buffers contíguos, e 'row_offsets[n]' indica onde começa a amostra n.
+  */
+class SparseDataset {
+private:
+    std::size_t dim = 0;
+    std::vector<std::size_t> row_offsets{0};
+    std::vector<std::uint32_t> indices;
+    std::vector<int> values;
+
+public:
+    SparseDataset() = default;
+
+    /**
+      * @param dimension A dimensão dos pontos de dados.
+      * @throws std::invalid_argument se a dimensão não couber em índices de 32 bits.
+      */
+    explicit SparseDataset(std::size_t dimension) : dim(dimension) {
+        if (dimension > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::invalid_argument("SparseDataset: dimensao grande demais para indices de 32 bits");
+        }
+    }
+
+    /**
+      * Converte um conjunto de dados denso guardado linha a linha em um único buffer, descartando os zeros.
+      *
+      * @param features Matriz N x dimension, linha a linha, com os pontos de dados.
+      * @param dimension A dimensão dos pontos de dados.
+      * @return O conjunto esparso.
+      */
+    static SparseDataset from_dense(std::span<const int> features, std::size_t dimension) {
+        if (dimension == 0 || features.size() % dimension != 0) {
+            throw std::invalid_argument("SparseDataset: o tamanho da entrada nao e multiplo da dimensao");
+        }
+        SparseDataset result(dimension);
+        result.row_offsets.reserve(features.size() / dimension + 1);
+        for (std::size_t first = 0; first < features.size(); first += dimension) {
+            result.push_back(features.subspan(first, dimension));
+        }
+        return result;
+    }
+
+    /**
+      * Converte um vetor 2D de pontos de dados, todos com a mesma dimensão, descartando os zeros.
+      */
+    static SparseDataset from_dense(const std::vector<std::vector<int>> &dataset) {
+        SparseDataset result(dataset.empty() ? 0 : dataset.front().size());
+        for (const auto &data: dataset) {
+            result.push_back(data);
+        }
+        return result;
+    }
+
+    /**
+      * Adiciona um ponto de dados denso ao final do conjunto, guardando apenas os valores não nulos.
+      *
+      * @param data Um vetor de inteiros com 'dimension' valores.
+      */
+    void push_back(std::span<const int> data) {
+        if (data.size() != dim) {
+            throw std::invalid_argument("SparseDataset: dimensao incorreta");
+        }
+        for (std::size_t j = 0; j < data.size(); ++j) {
+            if (data[j] != 0) {
+                indices.push_back(static_cast<std::uint32_t>(j));
+                values.push_back(data[j]);
+            }
+        }
+        row_offsets.push_back(indices.size());
+    }
+
+    /**
+      * Adiciona um ponto de dados esparso ao final do conjunto.
+      *
+      * @param data Os índices, em ordem crescente e menores que 'dimension', e os valores não nulos.
+      */
+    void push_back(SparseSample data) {
+        if (data.indices.size() != data.values.size()) {
+            throw std::invalid_argument("SparseDataset: numero de indices e de valores diferentes");
+        }
+        for (std::size_t k = 0; k < data.nnz(); ++k) {
+            if (data.indices[k] >= dim || (k > 0 && data.indices[k] <= data.indices[k - 1])) {
+                throw std::invalid_argument("SparseDataset: indices fora de ordem ou fora da dimensao");
+            }
+        }
+        indices.insert(indices.end(), data.indices.begin(), data.indices.end());
+        values.insert(values.end(), data.values.begin(), data.values.end());
+        row_offsets.push_back(indices.size());
+    }
+
+    /**
+      * Adiciona um valor não nulo à amostra que está sendo montada; 'end_row' conclui a amostra.
+      * Usado pelo leitor de CSV, que já garante a ordem dos índices.
+      */
+    void append(std::uint32_t index, int value) {
+        indices.push_back(index);
+        values.push_back(value);
+    }
+
+    void end_row() { row_offsets.push_back(indices.size()); }
+
+    /**
+      * Descarta os valores adicionados por 'append' desde o fim da última amostra.
+      */
+    void discard_row() {
+        indices.resize(row_offsets.back());
+        values.resize(row_offsets.back());
+    }
+
+    [[nodiscard]] std::size_t size() const { return row_offsets.size() - 1; }
+
+    [[nodiscard]] bool empty() const { return size() == 0; }
+
+    [[nodiscard]] std::size_t dimension() const { return dim; }
+
+    [[nodiscard]] std::size_t nnz() const { return indices.size(); }
+
+    SparseSample operator[](std::size_t n) const {
+        const std::size_t first = row_offsets[n];
+        const std::size_t count = row_offsets[n + 1] - first;
+        return {std::span<const std::uint32_t>(indices).subspan(first, count),
+                std::span<const int>(values).subspan(first, count)};
+    }
+};
+
+#endif //SINGLELAYERPERCEPTRON_SPARSE_H
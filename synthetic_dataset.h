@@ -0,0 +1,323 @@
+#ifndef SINGLELAYERPERCEPTRON_SYNTHETIC_DATASET_H
+#define SINGLELAYERPERCEPTRON_SYNTHETIC_DATASET_H
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "binary_dataset.h"
+#include "random.h"
+
+/**
+  * Parâmetros de um conjunto de dados sintético bipolar com 'classes' classes.
+  *
+  * Cada classe tem um protótipo bipolar aleatório e cada amostra é o protótipo da sua classe com alguns valores
+  * invertidos:
+  * - separable: exatamente floor(noise * dimension) valores invertidos por amostra. O gerador garante que esse
+  *   número é menor que metade da menor distância de Hamming entre dois protótipos, então cada classe é
+  *   linearmente separável das demais (o neurônio com os pesos do protótipo separa as classes).
+  * - noisy: cada valor é invertido independentemente com probabilidade 'noise', e a saída desejada de cada
+  *   amostra é trocada por outra classe com probabilidade 'label_noise'; o conjunto em geral não é separável.
+  */
+struct SyntheticSpec {
+    enum class Mode {
+        separable,
+        noisy
+    };
+
+    std::size_t rows = 0;
+    std::size_t dimension = 0;
+    std::size_t classes = 0;
+    Mode mode = Mode::separable;
+    double noise = 0.05;
+    double label_noise = 0.0;
+    std::uint64_t seed = 42;
+};
+
+/**
+  * Gera um conjunto de dados sintético em blocos de linhas independentes.
+  *
+  * Cada bloco usa o seu próprio fluxo de números aleatórios derivado da semente, então os blocos podem ser gerados
+  * em paralelo e em qualquer ordem, e o conjunto gerado depende apenas de SyntheticSpec (não do número de threads).
+  */
+class SyntheticGenerator {
+private:
+    SyntheticSpec spec;
+    std::size_t words_per_sample;
+    std::size_t rows_per_chunk;
+    std::size_t flips = 0;
+
+    // Protótipo de cada classe, empacotado como em PackedBipolarDataset
+    std::vector<std::uint64_t> prototypes;
+
+    /**
+      * Inverte os valores de uma amostra de acordo com o modo do conjunto.
+      */
+    void add_noise(SplitMix64 &rng, const std::uint64_t *prototype, std::uint64_t *sample) const {
+        const std::size_t dim = spec.dimension;
+        if (spec.mode == SyntheticSpec::Mode::separable) {
+            // Sorteia 'flips' posições distintas (uma posição já invertida difere do protótipo); como
+            // flips < dim / 2, as repetições são raras
+            for (std::size_t k = 0; k < flips;) {
+                const std::size_t j = rng.below(dim);
+                const std::uint64_t bit = std::uint64_t{1} << (j % 64);
+                if (((sample[j / 64] ^ prototype[j / 64]) & bit) == 0) {
+                    sample[j / 64] ^= bit;
+                    ++k;
+                }
+            }
+            return;
+        }
+        if (spec.noise <= 0) {
+            return;
+        }
+        if (spec.noise >= 1) {
+            for (std::size_t j = 0; j < dim; ++j) {
+                sample[j / 64] ^= std::uint64_t{1} << (j % 64);
+            }
+            return;
+        }
+        // As distâncias entre duas inversões seguem uma distribuição geométrica, então só as posições invertidas são sorteadas
+        const double log_keep = std::log1p(-spec.noise);
+        const auto skip = [&] {
+            const double gap = std::floor(std::log(1.0 - rng.uniform()) / log_keep);
+            return gap < static_cast<double>(dim) ? static_cast<std::size_t>(gap) : dim;
+        };
+        for (std::size_t j = skip(); j < dim; j += 1 + skip()) {
+            sample[j / 64] ^= std::uint64_t{1} << (j % 64);
+        }
+    }
+
+public:
+    /**
+      * Sorteia os protótipos das classes e valida os parâmetros.
+      *
+      * @param spec Os parâmetros do conjunto.
+      * @throws std::invalid_argument se os parâmetros forem inválidos ou se o modo separable não puder garantir a
+      *         separabilidade com o ruído pedido.
+      */
+    explicit SyntheticGenerator(const SyntheticSpec &spec)
+            : spec(spec), words_per_sample((spec.dimension + 63) / 64) {
+        if (spec.dimension == 0 || spec.classes == 0) {
+            throw std::invalid_argument("SyntheticGenerator: a dimensao e o numero de classes devem ser positivos");
+        }
+        if (spec.dimension > std::numeric_limits<std::uint32_t>::max() ||
+            spec.classes > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::invalid_argument("SyntheticGenerator: dimensao ou numero de classes grande demais");
+        }
+        if (!(spec.noise >= 0 && spec.noise <= 1) || !(spec.label_noise >= 0 && spec.label_noise <= 1)) {
+            throw std::invalid_argument("SyntheticGenerator: as taxas de ruido devem estar em [0, 1]");
+        }
+
+        // Blocos de cerca de 4M valores, para limitar a memória de cada thread
+        rows_per_chunk = std::clamp<std::size_t>((std::size_t{1} << 22) / spec.dimension, 1, 4096);
+
+        SplitMix64 rng(SplitMix64::derive(spec.seed, 0));
+        prototypes.resize(spec.classes * words_per_sample);
+        const std::size_t tail = spec.dimension % 64;
+        for (std::size_t c = 0; c < spec.classes; ++c) {
+            std::uint64_t *prototype = prototypes.data() + c * words_per_sample;
+            for (std::size_t k = 0; k < words_per_sample; ++k) {
+                prototype[k] = rng();
+            }
+            if (tail != 0) {
+                prototype[words_per_sample - 1] &= (std::uint64_t{1} << tail) - 1;
+            }
+        }
+
+        if (spec.mode == SyntheticSpec::Mode::separable) {
+            flips = static_cast<std::size_t>(spec.noise * static_cast<double>(spec.dimension));
+            std::size_t min_distance = spec.dimension;
+            for (std::size_t a = 0; a < spec.classes; ++a) {
+                for (std::size_t b = a + 1; b < spec.classes; ++b) {
+                    std::size_t distance = 0;
+                    for (std::size_t k = 0; k < words_per_sample; ++k) {
+                        distance += static_cast<std::size_t>(std::popcount(
+                                prototypes[a * words_per_sample + k] ^ prototypes[b * words_per_sample + k]));
+                    }
+                    min_distance = std::min(min_distance, distance);
+                }
+            }
+            if (2 * flips >= min_distance) {
+                throw std::invalid_argument("SyntheticGenerator: ruido grande demais para um conjunto separavel; "
+                                            "inverta no maximo " + std::to_string((min_distance - 1) / 2) +
+                                            " valores por amostra");
+            }
+        }
+    }
+
+    [[nodiscard]] const SyntheticSpec &parameters() const { return spec; }
+
+    [[nodiscard]] std::size_t words() const { return words_per_sample; }
+
+    [[nodiscard]] std::size_t chunk_rows() const { return rows_per_chunk; }
+
+    [[nodiscard]] std::size_t chunks() const { return (spec.rows + rows_per_chunk - 1) / rows_per_chunk; }
+
+    [[nodiscard]] std::size_t rows_in_chunk(std::size_t chunk) const {
+        return std::min(rows_per_chunk, spec.rows - chunk * rows_per_chunk);
+    }
+
+    /**
+      * Gera as amostras de um bloco de linhas.
+      *
+      * @param chunk O índice do bloco.
+      * @param features Recebe rows_in_chunk(chunk) x words() palavras com os pontos de dados empacotados.
+      * @param labels Recebe a classe de cada amostra do bloco.
+      */
+    void generate_chunk(std::size_t chunk, std::uint64_t *features, std::uint32_t *labels) const {
+        SplitMix64 rng(SplitMix64::derive(spec.seed, chunk + 1));
+        for (std::size_t n = 0; n < rows_in_chunk(chunk); ++n) {
+            const std::size_t cls = rng.below(spec.classes);
+            const std::uint64_t *prototype = prototypes.data() + cls * words_per_sample;
+            std::uint64_t *sample = features + n * words_per_sample;
+            std::copy_n(prototype, words_per_sample, sample);
+            add_noise(rng, prototype, sample);
+
+            std::size_t label = cls;
+            if (spec.mode == SyntheticSpec::Mode::noisy && spec.classes > 1 && rng.uniform() < spec.label_noise) {
+                label = (cls + 1 + rng.below(spec.classes - 1)) % spec.classes;
+            }
+            labels[n] = static_cast<std::uint32_t>(label);
+        }
+    }
+};
+
+namespace synthetic_detail {
+
+/**
+  * Gera os blocos em paralelo, em grupos de 'num_threads' blocos, e grava o conteúdo de cada grupo na ordem dos blocos.
+  *
+  * @param generator O gerador.
+  * @param num_threads O número de threads.
+  * @param format Gera e formata um bloco: recebe o índice do bloco e o buffer que recebe os bytes a gravar.
+  * @param out O arquivo de saída.
+  */
+inline void write_chunks(const SyntheticGenerator &generator, unsigned num_threads,
+                         const std::function<void(std::size_t, std::string &)> &format, std::ofstream &out) {
+    const std::size_t workers = std::max(num_threads, 1u);
+    std::vector<std::string> buffers(workers);
+    for (std::size_t first = 0; first < generator.chunks(); first += workers) {
+        const std::size_t count = std::min(workers, generator.chunks() - first);
+        {
+            std::vector<std::jthread> pool;
+            pool.reserve(count - 1);
+            for (std::size_t t = 1; t < count; ++t) {
+                pool.emplace_back([&, t] { format(first + t, buffers[t]); });
+            }
+            format(first, buffers[0]);
+        }
+        for (std::size_t t = 0; t < count; ++t) {
+            out.write(buffers[t].data(), static_cast<std::streamsize>(buffers[t].size()));
+        }
+    }
+}
+
+} // namespace synthetic_detail
+
+/**
+  * Grava um conjunto sintético no formato CSV de 'readData': os valores do ponto de dados seguidos das saídas
+  * desejadas bipolares (+1 na coluna da classe e -1 nas demais).
+  *
+  * @param generator O gerador.
+  * @param filename O caminho do arquivo.
+  * @param num_threads O número de threads usadas na geração.
+  * @throws std::runtime_error se o arquivo não puder ser gravado.
+  */
+inline void writeSyntheticCsv(const SyntheticGenerator &generator, const std::string &filename,
+                              unsigned num_threads = std::thread::hardware_concurrency()) {
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("writeSyntheticCsv: nao foi possivel criar " + filename);
+    }
+    const SyntheticSpec &spec = generator.parameters();
+    synthetic_detail::write_chunks(generator, num_threads, [&](std::size_t chunk, std::string &text) {
+        const std::size_t rows = generator.rows_in_chunk(chunk);
+        std::vector<std::uint64_t> features(rows * generator.words());
+        std::vector<std::uint32_t> labels(rows);
+        generator.generate_chunk(chunk, features.data(), labels.data());
+
+        text.clear();
+        text.reserve(rows * 3 * (spec.dimension + spec.classes));
+        for (std::size_t n = 0; n < rows; ++n) {
+            const std::uint64_t *sample = features.data() + n * generator.words();
+            for (std::size_t j = 0; j < spec.dimension; ++j) {
+                text += ((sample[j / 64] >> (j % 64)) & 1u) ? "1," : "-1,";
+            }
+            for (std::size_t i = 0; i < spec.classes; ++i) {
+                text += i == labels[n] ? "1" : "-1";
+                text += i + 1 < spec.classes ? ',' : '\n';
+            }
+        }
+    }, out);
+    if (!out) {
+        throw std::runtime_error("writeSyntheticCsv: erro ao gravar " + filename);
+    }
+}
+
+/**
+  * Grava um conjunto sintético no formato binário de conjuntos de dados (veja binary_dataset.h).
+  *
+  * @param generator O gerador.
+  * @param filename O caminho do arquivo.
+  * @param bipolar Se os pontos de dados são gravados empacotados; caso contrário são gravados como int32.
+  * @param num_threads O número de threads usadas na geração.
+  * @throws std::runtime_error se o arquivo não puder ser gravado.
+  */
+inline void writeSyntheticBinary(const SyntheticGenerator &generator, const std::string &filename, bool bipolar = true,
+                                 unsigned num_threads = std::thread::hardware_concurrency()) {
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("writeSyntheticBinary: nao foi possivel criar " + filename);
+    }
+    const SyntheticSpec &spec = generator.parameters();
+    const BinaryDatasetHeader header = makeBinaryDatasetHeader(bipolar, spec.rows, spec.dimension, spec.classes);
+    const char padding[64] = {};
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(padding, static_cast<std::streamsize>(header.feature_offset - sizeof(header)));
+
+    // As classes de todas as amostras são guardadas para gravar o bloco de saídas depois do bloco de pontos de dados
+    std::vector<std::uint32_t> classes(spec.rows);
+    synthetic_detail::write_chunks(generator, num_threads, [&](std::size_t chunk, std::string &bytes) {
+        const std::size_t rows = generator.rows_in_chunk(chunk);
+        std::vector<std::uint64_t> features(rows * generator.words());
+        generator.generate_chunk(chunk, features.data(), classes.data() + chunk * generator.chunk_rows());
+        if (bipolar) {
+            bytes.assign(reinterpret_cast<const char *>(features.data()), features.size() * sizeof(std::uint64_t));
+            return;
+        }
+        std::vector<std::int32_t> values(rows * spec.dimension);
+        for (std::size_t n = 0; n < rows; ++n) {
+            const std::uint64_t *sample = features.data() + n * generator.words();
+            for (std::size_t j = 0; j < spec.dimension; ++j) {
+                values[n * spec.dimension + j] = ((sample[j / 64] >> (j % 64)) & 1u) ? 1 : -1;
+            }
+        }
+        bytes.assign(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(std::int32_t));
+    }, out);
+
+    const std::uint64_t feature_bytes = bipolar ? spec.rows * generator.words() * sizeof(std::uint64_t)
+                                                : spec.rows * spec.dimension * sizeof(std::int32_t);
+    out.write(padding, static_cast<std::streamsize>(header.label_offset - header.feature_offset - feature_bytes));
+    std::vector<std::int32_t> row(spec.classes);
+    for (std::uint32_t cls: classes) {
+        std::fill(row.begin(), row.end(), -1);
+        row[cls] = 1;
+        out.write(reinterpret_cast<const char *>(row.data()),
+                  static_cast<std::streamsize>(row.size() * sizeof(std::int32_t)));
+    }
+    if (!out) {
+        throw std::runtime_error("writeSyntheticBinary: erro ao gravar " + filename);
+    }
+}
+
+#endif //SINGLELAYERPERCEPTRON_SYNTHETIC_DATASET_H
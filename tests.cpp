@@ -0,0 +1,541 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "binary_dataset.h"
+#include "csv_loader.h"
+#include "epoch_order.h"
+#include "fixed_single_layer_perceptron.h"
+#include "grid_trainer.h"
+#include "kernels.h"
+#include "model_handle.h"
+#include "random.h"
+#include "single_layer_perceptron.h"
+#include "sparse.h"
+
+/**
+  * Dá acesso aos pesos de SingleLayerPerceptron, que não fazem parte da interface pública.
+  */
+struct PerceptronTest {
+    static const double *row(const SingleLayerPerceptron &model, int i) {
+        return model.row(i);
+    }
+
+    template<std::size_t Dim, std::size_t Classes, typename Weight>
+    static const Weight *row(const FixedSingleLayerPerceptron<Dim, Classes, Weight> &model, std::size_t i) {
+        return model.row(i);
+    }
+};
+
+namespace {
+
+// Número de verificações que falharam
+std::size_t failures = 0;
+
+/**
+  * Registra uma verificação; uma falha é informada com o local e não interrompe os demais testes.
+  */
+void check(bool condition, const std::string &what, int line) {
+    if (!condition) {
+        ++failures;
+        std::cerr << "tests.cpp:" << line << ": falhou: " << what << '\n';
+    }
+}
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+/**
+  * Gera um conjunto bipolar aleatório com saídas one-hot de 'classes' classes (+1 na classe e -1 nas demais).
+  */
+void random_bipolar(std::size_t rows, std::size_t dimension, std::size_t classes, std::uint64_t seed,
+                    std::vector<std::vector<int>> &dataset, std::vector<std::vector<int>> &target) {
+    SplitMix64 rng(seed);
+    dataset.assign(rows, std::vector<int>(dimension));
+    target.assign(rows, std::vector<int>(classes, -1));
+    for (std::size_t n = 0; n < rows; ++n) {
+        for (int &value: dataset[n]) {
+            value = (rng() & 1u) ? 1 : -1;
+        }
+        target[n][rng.below(classes)] = 1;
+    }
+}
+
+/**
+  * Copia um conjunto de vetores 2D para um Dataset, com os mesmos valores em buffers contíguos.
+  */
+Dataset to_dataset(const std::vector<std::vector<int>> &dataset, const std::vector<std::vector<int>> &target) {
+    Dataset result;
+    result.rows = dataset.size();
+    result.data_columns = dataset.empty() ? 0 : dataset[0].size();
+    result.label_columns = target.empty() ? 0 : target[0].size();
+    for (std::size_t n = 0; n < dataset.size(); ++n) {
+        result.features.insert(result.features.end(), dataset[n].begin(), dataset[n].end());
+        result.labels.insert(result.labels.end(), target[n].begin(), target[n].end());
+    }
+    return result;
+}
+
+/**
+  * Verifica se dois modelos têm exatamente os mesmos pesos e bias.
+  */
+bool same_weights(const SingleLayerPerceptron &a, const SingleLayerPerceptron &b) {
+    if (a.input_dimension() != b.input_dimension() || a.class_count() != b.class_count()) {
+        return false;
+    }
+    const auto width = static_cast<std::size_t>(a.input_dimension()) + 1;
+    for (int i = 0; i < a.class_count(); ++i) {
+        if (std::memcmp(PerceptronTest::row(a, i), PerceptronTest::row(b, i), width * sizeof(double)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+  * Os kernels de cada conjunto de instruções suportado produzem resultados idênticos bit a bit aos escalares,
+  * incluindo os restos que não ocupam um vetor inteiro.
+  */
+void test_kernel_isa_parity() {
+    const kernels::KernelTable &scalar = kernels::table(kernels::Isa::scalar);
+    SplitMix64 rng(7);
+    for (const std::size_t n: {std::size_t{1}, std::size_t{7}, std::size_t{8}, std::size_t{63}, std::size_t{100},
+                               std::size_t{1031}}) {
+        std::vector<int> x(4 * n);
+        for (int &value: x) {
+            value = static_cast<int>(rng.below(2001)) - 1000;
+        }
+        std::vector<double> w(n);
+        for (double &value: w) {
+            value = rng.uniform() * 2.0 - 1.0;
+        }
+        std::vector<std::uint64_t> bits((n + 63) / 64);
+        for (std::uint64_t &word: bits) {
+            word = rng();
+        }
+
+        for (const kernels::Isa isa: {kernels::Isa::sse42, kernels::Isa::avx2, kernels::Isa::avx512}) {
+            if (!kernels::supported(isa)) {
+                continue;
+            }
+            const kernels::KernelTable &simd = kernels::table(isa);
+
+            double expected[kernels::lanes] = {};
+            double actual[kernels::lanes] = {};
+            scalar.dot(x.data(), w.data(), n, expected);
+            simd.dot(x.data(), w.data(), n, actual);
+            CHECK(std::memcmp(expected, actual, sizeof(expected)) == 0);
+
+            double expected4[kernels::dot4_rows * kernels::lanes] = {};
+            double actual4[kernels::dot4_rows * kernels::lanes] = {};
+            scalar.dot4(x.data(), n, w.data(), n, expected4);
+            simd.dot4(x.data(), n, w.data(), n, actual4);
+            CHECK(std::memcmp(expected4, actual4, sizeof(expected4)) == 0);
+
+            std::fill(std::begin(expected), std::end(expected), 0.0);
+            std::fill(std::begin(actual), std::end(actual), 0.0);
+            scalar.dot_bipolar(bits.data(), w.data(), n, expected);
+            simd.dot_bipolar(bits.data(), w.data(), n, actual);
+            CHECK(std::memcmp(expected, actual, sizeof(expected)) == 0);
+
+            std::vector<double> expected_w = w;
+            std::vector<double> actual_w = w;
+            scalar.axpy(x.data(), 0.25, expected_w.data(), n);
+            simd.axpy(x.data(), 0.25, actual_w.data(), n);
+            scalar.axpy_bipolar(bits.data(), -0.5, expected_w.data(), n);
+            simd.axpy_bipolar(bits.data(), -0.5, actual_w.data(), n);
+            CHECK(std::memcmp(expected_w.data(), actual_w.data(), n * sizeof(double)) == 0);
+        }
+    }
+}
+
+/**
+  * 'predict_batch' faz exatamente as mesmas previsões que 'predict' amostra a amostra, para todos os formatos de
+  * conjunto, incluindo um número de amostras que não é múltiplo dos blocos do kernel.
+  */
+void test_predict_batch_matches_predict() {
+    std::vector<std::vector<int>> dataset;
+    std::vector<std::vector<int>> target;
+    random_bipolar(203, 131, 5, 11, dataset, target);
+    SingleLayerPerceptron model(131, 5, 0.5, 0.0);
+    TrainOptions options;
+    options.max_epochs = 3;
+    model.train(dataset, target, options);
+
+    std::vector<std::vector<int>> expected;
+    for (const auto &data: dataset) {
+        expected.push_back(model.predict(data));
+    }
+    std::vector<int> flat;
+    for (const auto &output: expected) {
+        flat.insert(flat.end(), output.begin(), output.end());
+    }
+
+    CHECK(model.predict_batch(dataset) == expected);
+    const Dataset dense = to_dataset(dataset, target);
+    CHECK(model.predict_batch(dense) == flat);
+    CHECK(model.predict_batch(SparseDataset::from_dense(dataset)) == flat);
+
+    const std::string filename = (std::filesystem::temp_directory_path() / "slp_tests_batch.bin").string();
+    writeBinaryDataset(dense, filename);
+    {
+        const BinaryDataset binary(filename);
+        CHECK(binary.is_bipolar());
+        CHECK(model.predict_batch(binary) == flat);
+    }
+    std::filesystem::remove(filename);
+
+    PackedBipolarDataset packed;
+    CHECK(PackedBipolarDataset::pack(dataset, packed));
+    for (std::size_t n = 0; n < dataset.size(); ++n) {
+        CHECK(model.predict(packed[n]) == expected[n]);
+    }
+}
+
+/**
+  * O perceptron médio produz a média dos pesos iniciais e dos pesos após cada amostra visitada, calculada aqui
+  * diretamente, sem os acumuladores preguiçosos. Com taxa de aprendizado inteira, 'train_dual' dá o mesmo
+  * resultado.
+  */
+void test_average() {
+    std::vector<std::vector<int>> dataset;
+    std::vector<std::vector<int>> target;
+    random_bipolar(40, 24, 3, 5, dataset, target);
+    const std::size_t dimension = 24;
+    const std::size_t classes = 3;
+    TrainOptions options;
+    options.max_epochs = 6;
+    options.average = true;
+
+    SingleLayerPerceptron model(24, 3, 1.0, 0.0);
+    const TrainResult result = model.train(dataset, target, options);
+
+    // Referência: treina com pesos inteiros exatos e soma os pesos após cada passo
+    std::vector<std::vector<long long>> weights(classes, std::vector<long long>(dimension + 1, 0));
+    std::vector<std::vector<long long>> sums(classes, std::vector<long long>(dimension + 1, 0));
+    long long steps = 1;
+    for (std::size_t epoch = 0; epoch < result.last.epoch; ++epoch) {
+        for (std::size_t n = 0; n < dataset.size(); ++n) {
+            for (std::size_t i = 0; i < classes; ++i) {
+                long long net = weights[i][dimension];
+                for (std::size_t j = 0; j < dimension; ++j) {
+                    net += weights[i][j] * dataset[n][j];
+                }
+                const int output = net > 0 ? 1 : (net < -1 ? -1 : 0);
+                if (output != target[n][i]) {
+                    for (std::size_t j = 0; j < dimension; ++j) {
+                        weights[i][j] += target[n][i] * dataset[n][j];
+                    }
+                    weights[i][dimension] += target[n][i];
+                }
+            }
+            for (std::size_t i = 0; i < classes; ++i) {
+                for (std::size_t j = 0; j <= dimension; ++j) {
+                    sums[i][j] += weights[i][j];
+                }
+            }
+            ++steps;
+        }
+    }
+    bool close = true;
+    for (std::size_t i = 0; i < classes; ++i) {
+        for (std::size_t j = 0; j <= dimension; ++j) {
+            const double average = static_cast<double>(sums[i][j]) / static_cast<double>(steps);
+            close = close && std::fabs(PerceptronTest::row(model, static_cast<int>(i))[j] - average) <= 1e-9;
+        }
+    }
+    CHECK(close);
+
+    SingleLayerPerceptron dual(24, 3, 1.0, 0.0);
+    dual.train_dual(dataset, target, options);
+    bool same = true;
+    for (int i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j <= dimension; ++j) {
+            same = same && std::fabs(PerceptronTest::row(model, i)[j] - PerceptronTest::row(dual, i)[j]) <= 1e-9;
+        }
+    }
+    CHECK(same);
+}
+
+/**
+  * A mesma semente produz sempre as mesmas ordens e o mesmo treinamento; cada ordem é uma permutação e, com
+  * blocos, cada bloco continua contíguo.
+  */
+void test_shuffle_determinism() {
+    EpochOrder first(100, 3, 8);
+    EpochOrder second(100, 3, 8);
+    EpochOrder other(100, 4, 8);
+    bool differs = false;
+    for (std::size_t epoch = 1; epoch <= 5; ++epoch) {
+        first.shuffle(epoch);
+        second.shuffle(epoch);
+        other.shuffle(epoch);
+        CHECK(std::ranges::equal(first.order(), second.order()));
+        differs = differs || !std::ranges::equal(first.order(), other.order());
+
+        std::vector<std::size_t> sorted(first.order().begin(), first.order().end());
+        std::ranges::sort(sorted);
+        std::vector<std::size_t> identity(100);
+        std::iota(identity.begin(), identity.end(), std::size_t{0});
+        CHECK(sorted == identity);
+        // O último bloco é menor e pode aparecer em qualquer posição, então os blocos são percorridos pelo tamanho
+        for (std::size_t k = 0, count = 0; k < 100; k += count) {
+            const std::size_t block = first.order()[k] / 8;
+            count = std::min<std::size_t>(8, 100 - block * 8);
+            CHECK(std::all_of(first.order().begin() + static_cast<std::ptrdiff_t>(k),
+                              first.order().begin() + static_cast<std::ptrdiff_t>(k + count),
+                              [&](std::size_t n) { return n / 8 == block; }));
+        }
+    }
+    CHECK(differs);
+
+    std::vector<std::vector<int>> dataset;
+    std::vector<std::vector<int>> target;
+    random_bipolar(60, 32, 4, 9, dataset, target);
+    TrainOptions options;
+    options.max_epochs = 4;
+    options.shuffle = true;
+    options.shuffle_seed = 17;
+    SingleLayerPerceptron a(32, 4, 0.1, 0.0);
+    SingleLayerPerceptron b(32, 4, 0.1, 0.0);
+    const TrainResult ra = a.train(dataset, target, options);
+    const TrainResult rb = b.train(dataset, target, options);
+    CHECK(same_weights(a, b));
+    CHECK(ra.last.misclassifications == rb.last.misclassifications && ra.last.updates == rb.last.updates);
+}
+
+/**
+  * Treina um FixedSingleLayerPerceptron e um SingleLayerPerceptron com os mesmos dados e verifica se os pesos, as
+  * estatísticas do treinamento e as previsões coincidem. Com pesos double a comparação é bit a bit; com pesos
+  * inteiros, que não saturam nestes dados, os valores são os mesmos.
+  */
+template<typename Weight>
+void check_fixed_matches(double learning_rate, const TrainOptions &options) {
+    constexpr std::size_t dimension = 63;
+    constexpr std::size_t classes = 7;
+    std::vector<std::vector<int>> dataset;
+    std::vector<std::vector<int>> target;
+    random_bipolar(90, dimension, classes, 13, dataset, target);
+
+    FixedSingleLayerPerceptron<dimension, classes, Weight> fixed(learning_rate, 0.0);
+    SingleLayerPerceptron dynamic(dimension, classes, learning_rate, 0.0);
+    const TrainResult fixed_result = fixed.train(dataset, target, options);
+    const TrainResult dynamic_result = dynamic.train(dataset, target, options);
+
+    CHECK(fixed_result.reason == dynamic_result.reason);
+    CHECK(fixed_result.last.epoch == dynamic_result.last.epoch);
+    CHECK(fixed_result.last.updates == dynamic_result.last.updates);
+    CHECK(fixed_result.last.misclassifications == dynamic_result.last.misclassifications);
+    CHECK(fixed.saturations() == 0);
+    bool same = true;
+    for (std::size_t i = 0; i < classes; ++i) {
+        const Weight *expected_row = PerceptronTest::row(fixed, i);
+        const double *actual_row = PerceptronTest::row(dynamic, static_cast<int>(i));
+        for (std::size_t j = 0; j <= dimension; ++j) {
+            if constexpr (std::is_same_v<Weight, double>) {
+                same = same && std::memcmp(&expected_row[j], &actual_row[j], sizeof(double)) == 0;
+            } else {
+                same = same && static_cast<double>(expected_row[j]) == actual_row[j];
+            }
+        }
+    }
+    CHECK(same);
+    CHECK(fixed.predict_batch(dataset) == dynamic.predict_batch(dataset));
+}
+
+/**
+  * As três variantes de FixedSingleLayerPerceptron reproduzem SingleLayerPerceptron, com e sem embaralhamento;
+  * a variante double também com taxa de aprendizado fracionária. Pesos inteiros saturam em vez de transbordar.
+  */
+void test_fixed_model() {
+    TrainOptions options;
+    options.max_epochs = 30;
+    check_fixed_matches<double>(1.0, options);
+    check_fixed_matches<double>(0.1, options);
+    check_fixed_matches<std::int16_t>(1.0, options);
+    check_fixed_matches<std::int32_t>(2.0, options);
+    options.shuffle = true;
+    options.shuffle_seed = 21;
+    check_fixed_matches<double>(0.1, options);
+    check_fixed_matches<std::int16_t>(1.0, options);
+    check_fixed_matches<std::int32_t>(1.0, options);
+
+    FixedSingleLayerPerceptron<2, 1, std::int16_t> saturating(30000.0, 0.0);
+    TrainOptions few;
+    few.max_epochs = 3;
+    saturating.train({{1, 1}, {-1, -1}, {1, -1}}, {{1}, {-1}, {-1}}, few);
+    CHECK(saturating.saturations() > 0);
+    const std::int16_t *weights = PerceptronTest::row(saturating, 0);
+    CHECK(std::any_of(weights, weights + 3, [](std::int16_t w) {
+        return w == std::numeric_limits<std::int16_t>::max() || w == std::numeric_limits<std::int16_t>::min();
+    }));
+
+    bool rejected = false;
+    try {
+        FixedSingleLayerPerceptron<2, 1, std::int16_t> model(1.0, 0.0);
+        model.train({{1, 1}}, {{2}});
+    } catch (const std::invalid_argument &) {
+        rejected = true;
+    }
+    CHECK(rejected);
+}
+
+/**
+  * Cada modelo do GridTrainer termina com os mesmos pesos e o mesmo resultado que 'train' com os mesmos
+  * hiperparâmetros, inclusive com embaralhamento, perceptron médio e detecção de ciclos. A dimensão faz cada
+  * época passar por vários blocos de amostras.
+  */
+void test_grid_matches_train() {
+    std::vector<std::vector<int>> dataset;
+    std::vector<std::vector<int>> target;
+    random_bipolar(100, 2048, 3, 31, dataset, target);
+    const std::vector<double> learning_rates = {0.1, 1.0};
+    const std::vector<double> thetas = {0.0, 0.5};
+    const std::vector<GridPoint> points = GridTrainer::grid(learning_rates, thetas);
+
+    std::vector<TrainOptions> variants(4);
+    for (TrainOptions &options: variants) {
+        options.max_epochs = 5;
+    }
+    variants[1].shuffle = true;
+    variants[1].shuffle_seed = 8;
+    variants[1].shuffle_block = 16;
+    variants[2].average = true;
+    variants[3].detect_cycles = true;
+
+    for (const TrainOptions &options: variants) {
+        GridTrainer grid(2048, 3, points);
+        const std::vector<TrainResult> results = grid.train(dataset, target, options);
+        CHECK(results.size() == points.size());
+        for (std::size_t k = 0; k < points.size(); ++k) {
+            SingleLayerPerceptron model(2048, 3, points[k].learning_rate, points[k].theta);
+            const TrainResult expected = model.train(dataset, target, options);
+            CHECK(same_weights(grid.model(k), model));
+            CHECK(results[k].reason == expected.reason);
+            CHECK(results[k].cycle_length == expected.cycle_length);
+            CHECK(results[k].last.epoch == expected.last.epoch);
+            CHECK(results[k].last.updates == expected.last.updates);
+            CHECK(results[k].last.misclassifications == expected.last.misclassifications);
+        }
+    }
+
+    GridTrainer grid(2048, 3, points);
+    const std::vector<TrainResult> labeled = grid.train(to_dataset(dataset, target), variants[0]);
+    SingleLayerPerceptron model(2048, 3, points[0].learning_rate, points[0].theta);
+    model.train(dataset, target, variants[0]);
+    CHECK(same_weights(grid.model(0), model));
+
+    bool rejected = false;
+    try {
+        std::vector<std::vector<int>> narrow = target;
+        narrow[5].pop_back();
+        GridTrainer(2048, 3, points).train(dataset, narrow);
+    } catch (const std::invalid_argument &) {
+        rejected = true;
+    }
+    CHECK(rejected);
+}
+
+/**
+  * 'loadCsv' ignora as linhas malformadas e informa o número de cada uma, contando as linhas vazias e o BOM.
+  */
+void test_csv_error_lines() {
+    const std::string filename = (std::filesystem::temp_directory_path() / "slp_tests_errors.csv").string();
+    {
+        std::ofstream out(filename, std::ios::binary);
+        out << "\xEF\xBB\xBF"
+               "1\n"            // linha 1: colunas insuficientes antes da primeira linha válida
+               "1,-1,1\n"       // linha 2: a primeira linha válida define uma coluna de saída
+               "\n"             // linha 3: vazia
+               "-1,x,1\n"       // linha 4: campo não inteiro
+               "1,1,-1,1\n"     // linha 5: colunas demais
+               "1,1\n"          // linha 6: colunas de menos
+               " +1 , -1 ,-1\n" // linha 7: espaços e sinal '+'
+               "-1,-1,1";       // linha 8: sem quebra de linha no fim
+    }
+    const CsvData data = loadCsv(filename, 2);
+    std::filesystem::remove(filename);
+
+    CHECK(data.size() == 3);
+    CHECK(data.label_width() == 1);
+    std::vector<std::size_t> lines;
+    for (const CsvError &error: data.errors) {
+        lines.push_back(error.line);
+    }
+    CHECK((lines == std::vector<std::size_t>{1, 4, 5, 6}));
+    CHECK((data.features == std::vector<int>{1, -1, 1, -1, -1, -1}));
+    CHECK((data.labels == std::vector<int>{1, -1, 1}));
+}
+
+/**
+  * Uma versão substituída do ModelHandle continua válida enquanto uma leitura a usa, e só é liberada depois
+  * que a leitura termina.
+  */
+void test_model_handle_reclamation() {
+    SingleLayerPerceptron first(3, 1, 1.0, 0.0);
+    first.train(std::vector<std::vector<int>>{{1, 1, 1}}, std::vector<std::vector<int>>{{1}});
+    const std::vector<int> input = {1, 1, 1};
+
+    ModelHandle handle(first, 2);
+    ModelHandle::Reader reader(handle);
+    // Cada Reader só pode ter uma leitura em andamento, então a versão nova é lida por outro
+    ModelHandle::Reader other(handle);
+    {
+        const ModelHandle::Snapshot old = reader.read();
+        CHECK(old->predict(input) == std::vector<int>{1});
+
+        SingleLayerPerceptron next = handle.clone();
+        next.train(std::vector<std::vector<int>>{{1, 1, 1}}, std::vector<std::vector<int>>{{-1}});
+        CHECK(handle.publish(std::move(next)) == 2);
+
+        // A leitura em andamento impede a liberação e continua vendo a versão que leu
+        CHECK(handle.reclaim() == 1);
+        CHECK(old->predict(input) == std::vector<int>{1});
+        CHECK(other.read()->predict(input) == std::vector<int>{-1});
+    }
+    CHECK(handle.reclaim() == 0);
+    handle.synchronize();
+    CHECK(handle.version() == 2);
+
+    bool rejected = false;
+    try {
+        handle.publish(SingleLayerPerceptron(4, 1, 1.0, 0.0));
+    } catch (const std::invalid_argument &) {
+        rejected = true;
+    }
+    CHECK(rejected);
+}
+
+} // namespace
+
+int main() {
+    try {
+        test_kernel_isa_parity();
+        test_predict_batch_matches_predict();
+        test_average();
+        test_shuffle_determinism();
+        test_fixed_model();
+        test_grid_matches_train();
+        test_csv_error_lines();
+        test_model_handle_reclamation();
+    } catch (const std::exception &e) {
+        std::cerr << "excecao: " << e.what() << '\n';
+        return 1;
+    }
+    if (failures != 0) {
+        std::cerr << failures << " verificacoes falharam\n";
+        return 1;
+    }
+    std::cout << "todos os testes passaram\n";
+    return 0;
+}
@@ -0,0 +1,228 @@
+#ifndef SINGLELAYERPERCEPTRON_TRAINING_H
+#define SINGLELAYERPERCEPTRON_TRAINING_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <stdexcept>
+
+#include "cycle_detector.h"
+#include "epoch_order.h"
+
+/**
+  * Estatísticas de uma época de treinamento.
+  */
+struct EpochStats {
+    // Número da época, começando em 1
+    std::size_t epoch = 0;
+    // Número de pares (amostra, neurônio) cuja saída prevista difere da saída desejada
+    std::size_t misclassifications = 0;
+    // Número de atualizações aplicadas aos pesos (veja 'ch_weights')
+    std::size_t updates = 0;
+    // Número de pares (amostra, neurônio) avaliados
+    std::size_t evaluations = 0;
+    // Tempo desde o início do treinamento; só é medido quando há prazo ou callback
+    std::chrono::steady_clock::duration elapsed{};
+
+    [[nodiscard]] double error_rate() const {
+        return evaluations == 0 ? 0.0 : static_cast<double>(misclassifications) / static_cast<double>(evaluations);
+    }
+};
+
+/**
+  * Motivo pelo qual o treinamento parou.
+  */
+enum class StopReason {
+    // Todas as saídas previstas correspondem às desejadas
+    converged,
+    // A taxa de erro da época atingiu 'target_error_rate'
+    target_error_rate,
+    max_epochs,
+    deadline,
+    // Os pesos voltaram a um estado do fim de uma época anterior (veja 'TrainOptions::detect_cycles')
+    cycle
+};
+
+/**
+  * Limites e acompanhamento do treinamento. Os valores padrão treinam até convergir, como antes.
+  * Os limites são verificados ao fim de cada época.
+  */
+struct TrainOptions {
+    // Número máximo de épocas; 0 não limita
+    std::size_t max_epochs = 0;
+    // Instante a partir do qual nenhuma nova época é iniciada; o padrão não limita
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    // Para quando a taxa de erro de uma época for menor ou igual a este valor; 0 só para ao convergir
+    double target_error_rate = 0.0;
+    // Chamado ao fim de cada época; quando vazio, nenhum tempo é medido
+    std::function<void(const EpochStats &)> on_epoch;
+    // Para quando os pesos repetem o estado do fim de uma época anterior, já que a partir daí o treinamento
+    // repetiria o mesmo ciclo para sempre. A garantia só é exata com taxa de aprendizado e pesos iniciais inteiros;
+    // com taxas fracionárias, o ciclo é o da aritmética exata (veja cycle_detector.h)
+    bool detect_cycles = false;
+    // Visita as amostras em uma ordem aleatória diferente a cada época, sem movê-las (veja epoch_order.h).
+    // Ajuda a convergir quando o conjunto está ordenado, por exemplo por classe. Não pode ser usado com
+    // 'detect_cycles', que supõe que todas as épocas visitam as amostras na mesma ordem.
+    bool shuffle = false;
+    // Semente das ordens aleatórias; a mesma semente produz sempre o mesmo treinamento
+    std::uint64_t shuffle_seed = 0;
+    // Se não for 0, embaralha blocos com este número de amostras consecutivas e as amostras dentro de cada bloco,
+    // para que a leitura do conjunto de dados continue local
+    std::size_t shuffle_block = 0;
+    // Ao final, substitui os pesos pela média dos pesos após cada amostra visitada (perceptron médio), que
+    // generaliza melhor em dados ruidosos. A média é mantida de forma preguiçosa, com custo proporcional ao número
+    // de atualizações. Os pesos médios podem errar amostras de treinamento mesmo quando o treinamento converge.
+    bool average = false;
+};
+
+/**
+  * Resultado do treinamento.
+  */
+struct TrainResult {
+    StopReason reason = StopReason::converged;
+    // Estatísticas da última época executada
+    EpochStats last;
+    // Comprimento do ciclo, em épocas, quando o motivo é 'cycle'
+    std::size_t cycle_length = 0;
+};
+
+/**
+  * Decide, ao fim de uma época, se o treinamento deve parar.
+  *
+  * @param stats As estatísticas da época.
+  * @param options Os limites do treinamento.
+  * @param cycle_length O comprimento do ciclo encontrado pelo detector de ciclos, ou 0.
+  * @param deadline_passed Se o prazo de 'options' já passou.
+  * @return O motivo da parada, ou nada se o treinamento deve continuar.
+  */
+inline std::optional<StopReason> stop_reason(const EpochStats &stats, const TrainOptions &options,
+                                             std::size_t cycle_length, bool deadline_passed) {
+    if (stats.misclassifications == 0) {
+        return StopReason::converged;
+    }
+    if (stats.error_rate() <= options.target_error_rate) {
+        return StopReason::target_error_rate;
+    }
+    if (cycle_length != 0) {
+        return StopReason::cycle;
+    }
+    if (options.max_epochs != 0 && stats.epoch >= options.max_epochs) {
+        return StopReason::max_epochs;
+    }
+    if (deadline_passed) {
+        return StopReason::deadline;
+    }
+    return std::nullopt;
+}
+
+/**
+  * Acompanha as épocas de um treinamento: mede o tempo, alimenta o detector de ciclos e aplica as regras de parada
+  * de 'stop_reason' ao fim de cada época. É o estado de um modelo em 'run_epochs'; quem executa as épocas de
+  * vários modelos juntas (veja grid_trainer.h) usa um por modelo, com as mesmas regras.
+  */
+class EpochTracker {
+private:
+    using Clock = std::chrono::steady_clock;
+
+    const TrainOptions &options;
+    // O relógio só é consultado quando alguém usa o tempo
+    bool has_deadline;
+    bool timed;
+    Clock::time_point start;
+    std::optional<CycleDetector> cycles;
+    TrainResult outcome;
+
+public:
+    /**
+      * @param dataset Os dados de treinamento, usados pelo detector de ciclos.
+      * @param dimension A dimensão dos dados de entrada.
+      * @param num_classes O número de neurônios.
+      * @param options Os limites e o callback do treinamento; devem continuar válidos enquanto o objeto existir.
+      * @throws std::invalid_argument se 'detect_cycles' e 'shuffle' forem pedidos juntos.
+      */
+    template<typename Dataset>
+    EpochTracker(const Dataset &dataset, std::size_t dimension, std::size_t num_classes, const TrainOptions &options)
+            : options(options), has_deadline(options.deadline != Clock::time_point::max()),
+              timed(has_deadline || options.on_epoch), start(timed ? Clock::now() : Clock::time_point{}) {
+        if (options.detect_cycles && options.shuffle) {
+            throw std::invalid_argument("train: detect_cycles e shuffle nao podem ser usados juntos");
+        }
+        if (options.detect_cycles) {
+            cycles.emplace(dataset, dimension, num_classes);
+        }
+    }
+
+    /**
+      * @return O detector de ciclos que deve receber as atualizações dos pesos, ou nullptr.
+      */
+    [[nodiscard]] CycleDetector *cycle_detector() { return cycles ? &*cycles : nullptr; }
+
+    /**
+      * Encerra uma época: completa as estatísticas, chama 'on_epoch' e decide se o treinamento deve parar.
+      *
+      * @param stats As estatísticas da época, sem o número da época e o tempo decorrido.
+      * @param number O número da época, começando em 1.
+      * @return Verdadeiro se o treinamento deve parar; o motivo fica em 'result'.
+      */
+    bool end_epoch(EpochStats stats, std::size_t number) {
+        stats.epoch = number;
+        const Clock::time_point now = timed ? Clock::now() : Clock::time_point{};
+        stats.elapsed = now - start;
+        if (options.on_epoch) {
+            options.on_epoch(stats);
+        }
+        outcome.last = stats;
+        const std::size_t cycle_length = cycles ? cycles->end_epoch(number) : 0;
+
+        const auto reason = stop_reason(stats, options, cycle_length, has_deadline && now >= options.deadline);
+        if (!reason) {
+            return false;
+        }
+        outcome.reason = *reason;
+        outcome.cycle_length = *reason == StopReason::cycle ? cycle_length : 0;
+        return true;
+    }
+
+    /**
+      * @return O motivo da parada e as estatísticas da última época encerrada.
+      */
+    [[nodiscard]] const TrainResult &result() const { return outcome; }
+};
+
+/**
+  * Executa épocas de treinamento até que o modelo convirja ou que um dos limites de 'options' seja atingido.
+  * É o laço comum aos modelos; cada modelo fornece a sua época de treinamento.
+  *
+  * @param dataset Os dados de treinamento, usados pelo detector de ciclos.
+  * @param dimension A dimensão dos dados de entrada.
+  * @param num_classes O número de neurônios.
+  * @param options Os limites e o callback do treinamento.
+  * @param epoch Executa uma época: recebe o detector de ciclos (ou nullptr) e a ordem das amostras (vazia para a
+  *              ordem do conjunto de dados), e retorna as estatísticas da época.
+  * @return O motivo da parada e as estatísticas da última época.
+  */
+template<typename Dataset, typename Epoch>
+TrainResult run_epochs(const Dataset &dataset, std::size_t dimension, std::size_t num_classes,
+                       const TrainOptions &options, Epoch &&epoch) {
+    EpochTracker tracker(dataset, dimension, num_classes, options);
+    std::optional<EpochOrder> order;
+    if (options.shuffle) {
+        order.emplace(dataset.size(), options.shuffle_seed, options.shuffle_block);
+    }
+
+    for (std::size_t number = 1;; ++number) {
+        if (order) {
+            order->shuffle(number);
+        }
+        const EpochStats stats = epoch(tracker.cycle_detector(),
+                                       order ? order->order() : std::span<const std::size_t>{});
+        if (tracker.end_epoch(stats, number)) {
+            return tracker.result();
+        }
+    }
+}
+
+#endif //SINGLELAYERPERCEPTRON_TRAINING_H
@@ -0,0 +1,117 @@
+#ifndef SINGLELAYERPERCEPTRON_WEIGHT_MATRIX_H
+#define SINGLELAYERPERCEPTRON_WEIGHT_MATRIX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "mapped_file.h"
+
+/**
+  * Alocador que garante que o bloco de memória comece em um endereço múltiplo de Alignment bytes.
+  * É usado para que a matriz de pesos comece no início de uma linha de cache.
+  */
+template<typename T, std::size_t Alignment>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment> &) noexcept {}
+
+    T *allocate(std::size_t n) {
+        return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t{Alignment}));
+    }
+
+    void deallocate(T *p, std::size_t) noexcept {
+        ::operator delete(p, std::align_val_t{Alignment});
+    }
+
+    template<typename U>
+    bool operator==(const AlignedAllocator<U, Alignment> &) const noexcept { return true; }
+};
+
+/**
+  * Bloco de números decimais que guarda a matriz de pesos de um modelo.
+  * O bloco pode ser alocado na memória, alinhado a 64 bytes, ou ser uma região de um arquivo mapeado em memória
+  * no modo copy-on-write: neste caso os pesos são usados diretamente das páginas do arquivo, compartilhadas entre
+  * os processos que carregam o mesmo modelo, até que algum treinamento os altere.
+  */
+class WeightMatrix {
+private:
+    std::vector<double, AlignedAllocator<double, 64>> owned;
+    MappedFile mapping;
+    double *values = nullptr;
+    std::size_t count = 0;
+
+public:
+    /**
+      * Aloca um bloco de 'count' números decimais iguais a zero.
+      */
+    explicit WeightMatrix(std::size_t count) : owned(count, 0.0), values(owned.data()), count(count) {}
+
+    /**
+      * Usa como bloco 'count' números decimais de um arquivo mapeado, a partir do deslocamento 'offset'.
+      *
+      * @param file O arquivo mapeado no modo copy-on-write.
+      * @param offset O deslocamento do bloco no arquivo, múltiplo de 64 bytes.
+      * @param count O número de elementos do bloco.
+      */
+    WeightMatrix(MappedFile &&file, std::size_t offset, std::size_t count)
+            : mapping(std::move(file)), count(count) {
+        if (offset % 64 != 0 || offset > mapping.size() || count > (mapping.size() - offset) / sizeof(double)) {
+            throw std::invalid_argument("WeightMatrix: bloco fora do arquivo mapeado");
+        }
+        values = reinterpret_cast<double *>(mapping.mutable_data() + offset);
+    }
+
+    // A cópia sempre aloca um bloco próprio
+    WeightMatrix(const WeightMatrix &other)
+            : owned(other.values, other.values + other.count), values(owned.data()), count(other.count) {}
+
+    WeightMatrix &operator=(const WeightMatrix &other) {
+        if (this != &other) {
+            *this = WeightMatrix(other);
+        }
+        return *this;
+    }
+
+    // Mover o vetor ou o mapeamento não muda o endereço dos elementos
+    WeightMatrix(WeightMatrix &&other) noexcept
+            : owned(std::move(other.owned)), mapping(std::move(other.mapping)),
+              values(std::exchange(other.values, nullptr)), count(std::exchange(other.count, 0)) {}
+
+    WeightMatrix &operator=(WeightMatrix &&other) noexcept {
+        if (this != &other) {
+            owned = std::move(other.owned);
+            mapping = std::move(other.mapping);
+            values = std::exchange(other.values, nullptr);
+            count = std::exchange(other.count, 0);
+        }
+        return *this;
+    }
+
+    [[nodiscard]] double *data() { return values; }
+
+    [[nodiscard]] const double *data() const { return values; }
+
+    [[nodiscard]] std::size_t size() const { return count; }
+
+    // Verdadeiro se os pesos vêm de um arquivo mapeado em memória
+    [[nodiscard]] bool is_mapped() const { return mapping.data() != nullptr; }
+
+    bool operator==(const WeightMatrix &other) const {
+        return count == other.count && std::equal(values, values + count, other.values);
+    }
+};
+
+#endif //SINGLELAYERPERCEPTRON_WEIGHT_MATRIX_H